@@ -0,0 +1,85 @@
+// Runtime benchmark of units::quantity_accumulator of accumulator.hpp.
+// Prints the throughput and the error of summing float quantities given in kilometres
+// into metres: with a naive loop adding in float, then with the wide and the compensated
+// accumulations.
+#include <units/accumulator.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ratio>
+#include <vector>
+
+
+namespace
+{
+    struct Length : units::BaseDimension<Length> { static constexpr uint64_t ordinal = 1; };
+    struct metre : units::BaseUnit<metre, Length> {};
+    struct kilometre : units::ScaledUnit<kilometre, metre, units::MagnitudeFromRatio<std::kilo>> {};
+
+    constexpr size_t value_count = size_t(1) << 24u;
+    constexpr int repetitions = 5;
+
+    template<typename Fn>
+    double best_seconds(Fn&& fn)
+    {
+        double best = 1e30;
+        for(int i = 0; i < repetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = elapsed.count() < best ? elapsed.count() : best;
+        }
+        return best;
+    }
+
+    void report(const char* name, double seconds, double sum, long double exact)
+    {
+        std::printf("%-24s %8.0f Mvalues/s   relative error %.2e\n", name, double(value_count) / seconds * 1e-6,
+                    double(std::fabs((sum - exact) / exact)));
+    }
+}
+
+int main()
+{
+    std::vector<units::quantity<kilometre, float>> distances;
+    distances.reserve(value_count);
+    long double exact = 0;
+    for(size_t i = 0; i < value_count; ++i)
+    {
+        const float value = float(i % 1000) * 0.001f + 0.0001f;
+        distances.push_back(float(value) * kilometre{});
+        exact += (long double)(value) * 1000;
+    }
+
+    volatile double sink = 0;
+    double sum = 0;
+    const double naive = best_seconds([&]
+    {
+        units::quantity<metre, float> total = 0.f * metre{};
+        for(const auto& distance : distances)
+            total += distance.as(metre{});
+        sum = double(total.in(metre{}));
+        sink = sum;
+    });
+    report("naive float", naive, sum, exact);
+
+    const double wide = best_seconds([&]
+    {
+        units::quantity_accumulator<metre, float> total;
+        total.add(distances);
+        sum = total.value();
+        sink = sum;
+    });
+    report("wide (double)", wide, sum, exact);
+
+    const double compensated = best_seconds([&]
+    {
+        units::quantity_accumulator<metre, float, units::AccumulateCompensated<>> total;
+        total.add(distances);
+        sum = total.value();
+        sink = sum;
+    });
+    report("compensated (double)", compensated, sum, exact);
+}
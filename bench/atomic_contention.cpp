@@ -0,0 +1,84 @@
+// Runtime benchmark of units::atomic_quantity of atomic_quantity.hpp.
+// Prints the number of updates per second of a counter shared by 1 thread up to the
+// number of hardware threads, for an atomic_quantity and the std::atomic it wraps,
+// with integer and floating point values.
+#include <units/atomic_quantity.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ratio>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    struct Information : units::BaseDimension<Information> { static constexpr uint64_t ordinal = 4; };
+    struct Energy : units::BaseDimension<Energy> { static constexpr uint64_t ordinal = 5; };
+    struct byte : units::BaseUnit<byte, Information> {};
+    struct kilobyte : units::ScaledUnit<kilobyte, byte, units::MagnitudeFromRatio<std::kilo>> {};
+    struct joule : units::BaseUnit<joule, Energy> {};
+
+    constexpr int updates_per_thread = 1 << 20;
+
+    // Best time of the updates made by every thread at the same time
+    template<typename Update>
+    double run(size_t threads, Update update)
+    {
+        double best = 1e30;
+        for(int repetition = 0; repetition < 3; ++repetition)
+        {
+            std::vector<std::thread> workers;
+            const auto start = std::chrono::steady_clock::now();
+            for(size_t thread = 0; thread < threads; ++thread)
+                workers.emplace_back([&]
+                {
+                    for(int i = 0; i < updates_per_thread; ++i)
+                        update();
+                });
+            for(auto& worker : workers)
+                worker.join();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return double(threads) * updates_per_thread / best * 1e-6;
+    }
+}
+
+int main()
+{
+    units::atomic_quantity<byte, int64_t> bytes;
+    units::atomic_quantity<joule> energy;
+    std::atomic<int64_t> raw_bytes{0};
+    std::atomic<double> raw_energy{0};
+
+    std::printf("lock free: %s (int64_t), %s (double)\n", bytes.is_lock_free() ? "yes" : "no",
+                energy.is_lock_free() ? "yes" : "no");
+    std::printf("%8s %18s %18s %18s %18s\n", "threads", "quantity<B> Mop/s", "int64_t Mop/s",
+                "quantity<J> Mop/s", "double Mop/s");
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for(size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        const double quantity_int = run(threads, [&]
+        {
+            bytes.fetch_add(int64_t(1) * kilobyte{}, std::memory_order_relaxed);
+        });
+        const double raw_int = run(threads, [&] { raw_bytes.fetch_add(1000, std::memory_order_relaxed); });
+        const double quantity_float = run(threads, [&]
+        {
+            energy.fetch_add(0.5 * joule{}, std::memory_order_relaxed);
+        });
+        const double raw_float = run(threads, [&]
+        {
+            double current = raw_energy.load(std::memory_order_relaxed);
+            while(!raw_energy.compare_exchange_weak(current, current + 0.5, std::memory_order_relaxed))
+                ;
+        });
+        std::printf("%8zu %18.1f %18.1f %18.1f %18.1f\n", threads, quantity_int, raw_int, quantity_float, raw_float);
+        if(threads == max_threads)
+            break;
+    }
+}
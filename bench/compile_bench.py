@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+Compile-time benchmark of the units library.
+
+Generates synthetic translation units (a number of base dimensions, named and
+scaled units and chained `*`/`/` expressions over them), compiles each of them
+once with `-ftime-trace` (Clang) or `-ftime-report` (GCC) and prints a table of
+the wall time, peak RSS and template instantiation cost of every scenario.
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import subprocess
+import sys
+import time
+from dataclasses import dataclass
+
+
+@dataclass
+class Scenario:
+    name: str
+    dimensions: int
+    units: int
+    expressions: int
+    chain: int = 4
+    ordinals: bool = False
+
+
+SCENARIOS = [
+    Scenario("small", dimensions=4, units=16, expressions=16),
+    Scenario("medium", dimensions=8, units=64, expressions=64),
+    Scenario("medium_ordinals", dimensions=8, units=64, expressions=64, ordinals=True),
+    Scenario("large", dimensions=16, units=128, expressions=128, chain=6),
+    Scenario("large_ordinals", dimensions=16, units=128, expressions=128, chain=6, ordinals=True),
+]
+
+# Hand written translation units of bench/ and the macros they are built with
+STATIC_SCENARIOS = [
+    ("meta_long_lists_64", "meta_long_lists.cpp", ["-DUNITS_BENCH_LIST_SIZE=64"]),
+    ("meta_long_lists_256", "meta_long_lists.cpp", ["-DUNITS_BENCH_LIST_SIZE=256"]),
+]
+
+
+def generate(scenario):
+    # Fixed seed so the generated code, and then the measures, are reproducible
+    rng = random.Random(scenario.name)
+    lines = ["#include <ratio>", "#include <units.hpp>", ""]
+
+    for d in range(scenario.dimensions):
+        if scenario.ordinals:
+            lines.append(f"struct dim{d} : units::BaseDimension<dim{d}> "
+                         f"{{ static constexpr uint64_t ordinal = {d + 1}; }};")
+        else:
+            lines.append(f"struct dim{d} : units::BaseDimension<dim{d}> {{}};")
+    lines.append("")
+
+    # One base unit per dimension, then scaled units of them
+    for u in range(scenario.units):
+        if u < scenario.dimensions:
+            lines.append(f"struct unit{u} : units::BaseUnit<unit{u}, dim{u}> {{}};")
+        else:
+            base = rng.randrange(scenario.dimensions)
+            num = rng.randrange(2, 10000)
+            den = rng.randrange(1, 1000)
+            lines.append(f"struct unit{u} : units::ScaledUnit<unit{u}, unit{base}, "
+                         f"units::MagnitudeFromRatio<std::ratio<{num}, {den}>>> {{}};")
+    lines.append("")
+
+    for e in range(scenario.expressions):
+        expr = f"(1.5 * unit{rng.randrange(scenario.units)}{{}})"
+        for _ in range(scenario.chain):
+            op = rng.choice("*/")
+            expr = f"({expr} {op} (2.0 * unit{rng.randrange(scenario.units)}{{}}))"
+        lines.append(f"double expression{e}() {{ auto q = {expr}; return q.in(decltype(q)::unit{{}}); }}")
+
+    return "\n".join(lines) + "\n"
+
+
+def run_compiler(command):
+    """Run the compiler, returns its stderr, wall time in seconds and peak RSS in MB (or None)"""
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    stderr = process.stderr.read()
+    peak_rss = None
+    if hasattr(os, "wait4"):
+        # The rusage of the waited child also accounts for the compiler proper,
+        # which is a child of the driver
+        _, status, usage = os.wait4(process.pid, 0)
+        returncode = os.waitstatus_to_exitcode(status)
+        peak_rss = usage.ru_maxrss / 1024
+        if sys.platform == "darwin":
+            peak_rss /= 1024  # ru_maxrss is in bytes on macOS
+    else:
+        returncode = process.wait()
+    wall = time.perf_counter() - start
+    if returncode != 0:
+        sys.stderr.write(stderr)
+        raise RuntimeError(f"Compilation failed: {' '.join(command)}")
+    return stderr, wall, peak_rss
+
+
+def clang_instantiations(trace_file):
+    """Number and total duration (in seconds) of the instantiation events of a -ftime-trace file"""
+    with open(trace_file) as f:
+        events = json.load(f)["traceEvents"]
+    count = sum(1 for e in events if e.get("name") in ("InstantiateClass", "InstantiateFunction"))
+    # The "Total" events aggregate the time of every instantiation of a kind, in microseconds
+    total = sum(e.get("dur", 0) for e in events
+                if e.get("name") in ("Total InstantiateClass", "Total InstantiateFunction"))
+    return count, total / 1e6
+
+
+def gcc_instantiation_time(report):
+    """Wall time (in seconds) of the template instantiation phase of a -ftime-report output"""
+    for line in report.splitlines():
+        if line.strip().startswith("template instantiation"):
+            # eg: " template instantiation : 0.50 ( 20%) 0.01 (  5%) 0.52 ( 19%) 12M ( 15%)"
+            # the times are user, system then wall
+            times = re.findall(r"(\d+\.\d+)\s*\(", line.split(":", 1)[1])
+            return float(times[2])
+    return None
+
+
+def measure(args, name, source, extra_flags):
+    obj = os.path.join(args.work_dir, name + ".o")
+    command = [args.compiler, "-std=c++17", "-I", args.include_dir, "-c", source, "-o", obj]
+    command += extra_flags
+    is_clang = "Clang" in args.compiler_id
+    if is_clang:
+        command.append("-ftime-trace")
+    elif args.compiler_id == "GNU":
+        command.append("-ftime-report")
+
+    stderr, wall, peak_rss = run_compiler(command)
+
+    count, instantiation_time = None, None
+    if is_clang:
+        count, instantiation_time = clang_instantiations(os.path.splitext(obj)[0] + ".json")
+    elif args.compiler_id == "GNU":
+        instantiation_time = gcc_instantiation_time(stderr)
+    return wall, peak_rss, count, instantiation_time
+
+
+def fmt(value, spec):
+    return "n/a" if value is None else format(value, spec)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--compiler", default="c++")
+    parser.add_argument("--compiler-id", default="GNU", help="CMAKE_CXX_COMPILER_ID of the compiler")
+    parser.add_argument("--include-dir", required=True)
+    parser.add_argument("--bench-dir", required=True, help="Directory of the hand written benchmarks")
+    parser.add_argument("--work-dir", required=True)
+    args = parser.parse_args()
+
+    os.makedirs(args.work_dir, exist_ok=True)
+
+    rows = []
+    for scenario in SCENARIOS:
+        source = os.path.join(args.work_dir, scenario.name + ".cpp")
+        with open(source, "w") as f:
+            f.write(generate(scenario))
+        shape = f"{scenario.dimensions}/{scenario.units}/{scenario.expressions}"
+        rows.append((scenario.name, shape) + measure(args, scenario.name, source, []))
+
+    for name, file, flags in STATIC_SCENARIOS:
+        rows.append((name, "-") + measure(args, name, os.path.join(args.bench_dir, file), flags))
+
+    header = ("scenario", "dims/units/exprs", "wall (s)", "peak RSS (MB)",
+              "instantiations", "instantiation (s)")
+    table = [header] + [(name, shape, fmt(wall, ".2f"), fmt(rss, ".0f"), fmt(count, "d"),
+                         fmt(inst_time, ".2f"))
+                        for name, shape, wall, rss, count, inst_time in rows]
+    widths = [max(len(row[i]) for row in table) for i in range(len(header))]
+    for i, row in enumerate(table):
+        print(" | ".join(cell.ljust(width) for cell, width in zip(row, widths)))
+        if i == 0:
+            print("-+-".join("-" * width for width in widths))
+
+
+if __name__ == "__main__":
+    main()
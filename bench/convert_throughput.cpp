@@ -0,0 +1,60 @@
+// Runtime benchmark of the batch unit conversion of convert.hpp.
+// Prints the throughput of units::convert for several element types, next to
+// the one of a plain memcpy of the same buffers as a memory bandwidth reference.
+#include <units/convert.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ratio>
+#include <vector>
+
+
+namespace
+{
+    struct Length : units::BaseDimension<Length> { static constexpr uint64_t ordinal = 1; };
+    struct metre : units::BaseUnit<metre, Length> {};
+    struct kilometre : units::ScaledUnit<kilometre, metre, units::MagnitudeFromRatio<std::kilo>> {};
+
+    // 64 MiB per buffer, well out of the caches
+    constexpr size_t buffer_bytes = size_t(64) << 20u;
+    constexpr int repetitions = 10;
+
+    template<typename Fn>
+    double best_seconds(Fn&& fn)
+    {
+        double best = 1e30;
+        for(int i = 0; i < repetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = elapsed.count() < best ? elapsed.count() : best;
+        }
+        return best;
+    }
+
+    template<typename T>
+    void run(const char* name)
+    {
+        const size_t n = buffer_bytes / sizeof(T);
+        std::vector<units::quantity<kilometre, T>> in(n, T(3) * kilometre{});
+        std::vector<units::quantity<metre, T>> out(n, T(0) * metre{});
+
+        // read + write
+        const double bytes = 2.0 * double(n * sizeof(T));
+        const double convert = best_seconds([&] { units::convert(in, out); });
+        const double copy = best_seconds([&] { std::memcpy(out.data(), in.data(), n * sizeof(T)); });
+        std::printf("%-8s convert: %6.2f GB/s   memcpy: %6.2f GB/s\n", name, bytes / convert / 1e9,
+                    bytes / copy / 1e9);
+    }
+}
+
+
+int main()
+{
+    run<float>("float");
+    run<double>("double");
+    run<int32_t>("int32");
+    run<int64_t>("int64");
+}
@@ -0,0 +1,79 @@
+// Compile-time benchmark of the meta.hpp list algorithms on long lists.
+// Nothing happens at runtime, what is measured is the time and memory the
+// compiler needs for this translation unit, eg:
+// `/usr/bin/time -v c++ -std=c++17 -Iinclude -DUNITS_BENCH_LIST_SIZE=128 -c bench/meta_long_lists.cpp`
+// It is also part of the units_compile_bench target.
+#include <units/meta.hpp>
+#include <units/power.hpp>
+
+#include <cstddef>
+#include <utility>
+
+
+#ifndef UNITS_BENCH_LIST_SIZE
+#define UNITS_BENCH_LIST_SIZE 64
+#endif
+
+namespace
+{
+    constexpr int list_size = UNITS_BENCH_LIST_SIZE;
+
+    template<int N>
+    struct tag
+    {
+        static constexpr int value = N;
+    };
+
+    struct TagComparator
+    {
+        using key_type = int;
+
+        template<typename TagType>
+        static constexpr key_type key(const TagType&)
+        {
+            return TagType::type::Base::value;
+        }
+
+        template<typename TagType1, typename TagType2>
+        constexpr auto operator()(const TagType1&, const TagType2&) const
+        {
+            return meta::val<meta::compare_keys(key(TagType1{}), key(TagType2{}))>;
+        }
+    };
+
+    // Powers of tag<Offset + Stride * I> with the given exponent
+    template<int Offset, int Stride, int Exponent, std::size_t... I>
+    constexpr auto make_list(std::index_sequence<I...>)
+    {
+        return meta::typelist<units::Power<tag<Offset + Stride * int(I)>, Exponent>...>{};
+    }
+
+    template<int Offset, int Stride, int Exponent, int Size = list_size>
+    using list = decltype(make_list<Offset, Stride, Exponent>(std::make_index_sequence<Size>{}));
+
+    using all = list<0, 1, 1>;
+    using evens = list<0, 2, 1, list_size / 2>;
+    using odds = list<1, 2, 1, list_size / 2>;
+    using inverse_all = list<0, 1, -1>;
+    using reversed = list<list_size - 1, -1, 1>;
+
+    using merged = decltype(meta::merge(evens{}, odds{}, TagComparator{}));
+    static_assert(std::is_same_v<merged, all>);
+
+    using combined = decltype(meta::merge_combine_filter(all{}, evens{}, TagComparator{},
+                                                         units::detail::PowerCombiner{}));
+    static_assert(combined::size() == list_size);
+
+    using cancelled = decltype(meta::merge_combine_filter(all{}, inverse_all{}, TagComparator{},
+                                                          units::detail::PowerCombiner{}));
+    static_assert(std::is_same_v<cancelled, meta::typelist<>>);
+
+    using sorted = decltype(meta::sort(reversed{}, TagComparator{}));
+    static_assert(std::is_same_v<sorted, all>);
+
+    constexpr int exponent_sum = meta::reduce(0, all{}, [](int acc, auto powerType)
+    {
+        return acc + decltype(powerType)::type::exponent;
+    });
+    static_assert(exponent_sum == list_size);
+}
@@ -0,0 +1,111 @@
+// Runtime benchmark of units::parse_lines of parse.hpp.
+// Prints the throughput of reading one quantity per line, next to the one of a naive
+// parser reading the number with strtod and looking the unit up in a std::map.
+#include <units/parse.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <ratio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    struct Length : units::BaseDimension<Length> { static constexpr uint64_t ordinal = 1; };
+    struct Time : units::BaseDimension<Time> { static constexpr uint64_t ordinal = 2; };
+    struct Speed : units::CombinedDimension<Speed, units::Power<Length, 1>, units::Power<Time, -1>> {};
+    struct metre : units::BaseUnit<metre, Length> { static constexpr std::string_view symbol = "m"; };
+    struct kilometre : units::ScaledUnit<kilometre, metre, units::MagnitudeFromRatio<std::kilo>>
+    {
+        static constexpr std::string_view symbol = "km";
+    };
+    struct second : units::BaseUnit<second, Time> { static constexpr std::string_view symbol = "s"; };
+    struct hour : units::ScaledUnit<hour, second, units::MagnitudeFromInt<3600>>
+    {
+        static constexpr std::string_view symbol = "h";
+    };
+    struct metre_per_second : units::BaseUnit<metre_per_second, Speed> {};
+
+    using known_units = units::symbol_table<metre, kilometre, second, hour>;
+
+    constexpr size_t line_count = size_t(1) << 22u;
+    constexpr int repetitions = 5;
+
+    template<typename Fn>
+    double best_seconds(Fn&& fn)
+    {
+        double best = 1e30;
+        for(int i = 0; i < repetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = elapsed.count() < best ? elapsed.count() : best;
+        }
+        return best;
+    }
+
+    // Reads the number with strtod, then the unit as a string looked up in a map
+    size_t naive_parse(const std::string& text, std::vector<double>& out)
+    {
+        static const std::map<std::string, double> factors = {
+            {"m/s", 1.0}, {"km/h", 1000.0 / 3600.0}, {"km/s", 1000.0}, {"m/h", 1.0 / 3600.0}};
+        size_t count = 0;
+        const char* it = text.c_str();
+        const char* end = it + text.size();
+        while(it < end && count < out.size())
+        {
+            char* number_end;
+            const double value = std::strtod(it, &number_end);
+            const char* unit = number_end;
+            while(*unit == ' ')
+                ++unit;
+            const char* line_end = unit;
+            while(line_end < end && *line_end != '\n')
+                ++line_end;
+            out[count++] = value * factors.at(std::string(unit, line_end));
+            it = line_end + 1;
+        }
+        return count;
+    }
+
+    std::string make_lines(bool same_unit)
+    {
+        const char* symbols[] = {"m/s", "km/h", "km/s", "m/h"};
+        std::string text;
+        char line[64];
+        for(size_t i = 0; i < line_count; ++i)
+        {
+            const int size = std::snprintf(line, sizeof(line), "%.3f %s\n", double(i % 100000) * 0.125,
+                                           symbols[same_unit ? 1 : (i / 16) % 4]);
+            text.append(line, size_t(size));
+        }
+        return text;
+    }
+
+    void run(const char* name, bool same_unit)
+    {
+        const std::string text = make_lines(same_unit);
+        std::vector<units::quantity<metre_per_second>> speeds(line_count, 0.0 * metre_per_second{});
+        std::vector<double> naive(line_count);
+
+        const double parse = best_seconds([&] {
+            units::parse_lines(text, units::span<units::quantity<metre_per_second>>(speeds.data(), speeds.size()),
+                               known_units{});
+        });
+        const double baseline = best_seconds([&] { naive_parse(text, naive); });
+        const double megabytes = double(text.size()) / 1e6;
+        std::printf("%-12s parse_lines: %7.1f MB/s   strtod + map: %7.1f MB/s\n", name, megabytes / parse,
+                    megabytes / baseline);
+    }
+}
+
+
+int main()
+{
+    run("same unit", true);
+    run("mixed units", false);
+}
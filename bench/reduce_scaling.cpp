@@ -0,0 +1,82 @@
+// Runtime benchmark of units::reduce and units::inner_product of parallel.hpp.
+// Prints the time of both over a large buffer of quantities for 1 thread up to
+// the number of hardware threads, in the default and in the deterministic mode,
+// and the speedup over the sequential version.
+#include <units/parallel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    struct Length : units::BaseDimension<Length> { static constexpr uint64_t ordinal = 1; };
+    struct Force : units::BaseDimension<Force> { static constexpr uint64_t ordinal = 6; };
+    struct Work : units::CombinedDimension<Work, units::Power<Force, 1>, units::Power<Length, 1>> {};
+    struct metre : units::BaseUnit<metre, Length> {};
+    struct newton : units::BaseUnit<newton, Force> {};
+    struct joule : units::BaseUnit<joule, Work> {};
+
+    constexpr size_t value_count = size_t(1) << 25u;
+    constexpr int repetitions = 5;
+
+    template<typename Fn>
+    double best_seconds(Fn&& fn)
+    {
+        double best = 1e30;
+        for(int i = 0; i < repetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = elapsed.count() < best ? elapsed.count() : best;
+        }
+        return best;
+    }
+
+    // keeps the results alive so that the computations are not optimized away
+    volatile double sink;
+}
+
+int main()
+{
+    std::vector<units::quantity<metre>> distances;
+    std::vector<units::quantity<newton>> forces;
+    distances.reserve(value_count);
+    forces.reserve(value_count);
+    for(size_t i = 0; i < value_count; ++i)
+    {
+        distances.push_back(double(i % 1000) * 0.001 * metre{});
+        forces.push_back(double(i % 17) * newton{});
+    }
+
+    const double seq_reduce = best_seconds([&] { sink = units::reduce(units::execution::seq, distances).in(metre{}); });
+    const double seq_inner = best_seconds(
+        [&] { sink = units::inner_product(units::execution::seq, distances, forces).in(joule{}); });
+    std::printf("%zu values, sequential: reduce %.2f ms, inner_product %.2f ms\n", value_count,
+                seq_reduce * 1e3, seq_inner * 1e3);
+
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    units::thread_pool pool(max_threads);
+    std::printf("%8s %14s %24s %14s %24s\n", "threads", "reduce (ms)", "deterministic reduce (ms)",
+                "inner (ms)", "deterministic inner (ms)");
+    // 1, 2, 4... and the number of hardware threads
+    for(size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        const units::execution::parallel_policy fast{&pool, threads, false};
+        const units::execution::parallel_policy deterministic{&pool, threads, true};
+        const double times[] = {
+            best_seconds([&] { sink = units::reduce(fast, distances).in(metre{}); }),
+            best_seconds([&] { sink = units::reduce(deterministic, distances).in(metre{}); }),
+            best_seconds([&] { sink = units::inner_product(fast, distances, forces).in(joule{}); }),
+            best_seconds([&] { sink = units::inner_product(deterministic, distances, forces).in(joule{}); })};
+        std::printf("%8zu %8.2f x%4.1f %18.2f x%4.1f %8.2f x%4.1f %18.2f x%4.1f\n", threads,
+                    times[0] * 1e3, seq_reduce / times[0], times[1] * 1e3, seq_reduce / times[1],
+                    times[2] * 1e3, seq_inner / times[2], times[3] * 1e3, seq_inner / times[3]);
+        if(threads == max_threads)
+            break;
+    }
+}
@@ -0,0 +1,78 @@
+// Runtime benchmark of units::sharded_quantity_counter of sharded_counter.hpp.
+// Prints the total number of updates per second of a counter shared by 1 up to 64 threads,
+// for a sharded counter and for a single std::atomic, with integer and floating point values.
+// The sharded counter scales with the number of threads up to the number of cores.
+#include <units/sharded_counter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ratio>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    struct Information : units::BaseDimension<Information> { static constexpr uint64_t ordinal = 4; };
+    struct Energy : units::BaseDimension<Energy> { static constexpr uint64_t ordinal = 5; };
+    struct byte : units::BaseUnit<byte, Information> {};
+    struct kilobyte : units::ScaledUnit<kilobyte, byte, units::MagnitudeFromRatio<std::kilo>> {};
+    struct joule : units::BaseUnit<joule, Energy> {};
+
+    constexpr size_t max_threads = 64;
+    constexpr int updates_per_thread = 1 << 18;
+
+    // Best rate of the updates made by every thread at the same time, in millions per second
+    template<typename Update>
+    double run(size_t threads, Update update)
+    {
+        double best = 1e30;
+        for(int repetition = 0; repetition < 3; ++repetition)
+        {
+            std::atomic<bool> go{false};
+            std::vector<std::thread> workers;
+            for(size_t thread = 0; thread < threads; ++thread)
+                workers.emplace_back([&]
+                {
+                    while(!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    for(int i = 0; i < updates_per_thread; ++i)
+                        update();
+                });
+            const auto start = std::chrono::steady_clock::now();
+            go.store(true, std::memory_order_release);
+            for(auto& worker : workers)
+                worker.join();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return double(threads) * updates_per_thread / best * 1e-6;
+    }
+}
+
+int main()
+{
+    units::sharded_quantity_counter<byte, int64_t> bytes(max_threads);
+    units::sharded_quantity_counter<joule> energy(max_threads);
+    std::atomic<int64_t> shared_bytes{0};
+    units::atomic_quantity<joule> shared_energy;
+
+    std::printf("%u hardware threads, %zu shards\n", std::thread::hardware_concurrency(), bytes.shard_count());
+    std::printf("%8s %20s %20s %20s %20s\n", "threads", "sharded B (Mop/s)", "atomic B (Mop/s)",
+                "sharded J (Mop/s)", "atomic J (Mop/s)");
+    for(size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const double sharded_int = run(threads, [&] { bytes.add(int64_t(1) * kilobyte{}); });
+        const double atomic_int = run(threads, [&] { shared_bytes.fetch_add(1000, std::memory_order_relaxed); });
+        const double sharded_float = run(threads, [&] { energy.add(0.5 * joule{}); });
+        const double atomic_float = run(threads, [&]
+        {
+            shared_energy.fetch_add(0.5 * joule{}, std::memory_order_relaxed);
+        });
+        std::printf("%8zu %20.1f %20.1f %20.1f %20.1f\n", threads, sharded_int, atomic_int, sharded_float,
+                    atomic_float);
+    }
+}
@@ -1,15 +1,34 @@
 #ifndef UNITS_HPP
 #define UNITS_HPP
 
+#include "units/accumulator.hpp"
+#include "units/atomic_quantity.hpp"
+#include "units/chrono.hpp"
+#include "units/column_file.hpp"
+#include "units/convert.hpp"
 #include "units/dimension.hpp"
 #include "units/downcast.hpp"
+#include "units/dyn_quantity.hpp"
+#include "units/expression.hpp"
+#include "units/format.hpp"
 #include "units/magnitude.hpp"
 #include "units/meta.hpp"
+#include "units/ordinal.hpp"
+#include "units/parse.hpp"
 #include "units/power.hpp"
 #include "units/primes.hpp"
 #include "units/quantity.hpp"
+#include "units/quantity_channel.hpp"
+#include "units/quantity_span.hpp"
+#include "units/quantity_vector.hpp"
+#include "units/serialize.hpp"
+#include "units/sharded_counter.hpp"
+#include "units/span.hpp"
+#include "units/symbol.hpp"
 #include "units/type_name.hpp"
 #include "units/unit.hpp"
+#include "units/unit_registry.hpp"
+#include "units/views.hpp"
 
 
 #endif // UNITS_HPP
\ No newline at end of file
@@ -0,0 +1,247 @@
+#ifndef ACCUMULATOR_HPP
+#define ACCUMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include "quantity.hpp"
+
+
+namespace units
+{
+    /**
+     * Sum in the type Wide, eg float quantities summed in double
+     */
+    template<typename Wide = double>
+    struct AccumulateWide
+    {
+        using type = Wide;
+
+        template<size_t Lanes>
+        struct state
+        {
+            Wide sum[Lanes] = {};
+        };
+
+        template<size_t Lanes>
+        static constexpr void add(state<Lanes>& s, size_t lane, const Wide& value)
+        {
+            s.sum[lane] += value;
+        }
+
+        template<size_t Lanes>
+        static constexpr Wide total(const state<Lanes>& s)
+        {
+            // pairwise so that the lanes are added in the same order whatever the compiler
+            Wide lanes[Lanes] = {};
+            for(size_t i = 0; i < Lanes; ++i)
+                lanes[i] = s.sum[i];
+            for(size_t width = Lanes / 2; width > 0; width /= 2)
+                for(size_t i = 0; i < width; ++i)
+                    lanes[i] += lanes[i + width];
+            return lanes[0];
+        }
+    };
+
+    /**
+     * Sum in the type Wide with Neumaier compensation: the rounding error of every
+     * addition is kept in a second sum, so that the result is as accurate as if it was
+     * computed with twice the precision of Wide. Wide must be a floating point type.
+     */
+    template<typename Wide = double>
+    struct AccumulateCompensated
+    {
+        static_assert(std::is_floating_point_v<Wide>, "Compensated summation needs a floating point type");
+
+        using type = Wide;
+
+        template<size_t Lanes>
+        struct state
+        {
+            Wide sum[Lanes] = {};
+            Wide compensation[Lanes] = {};
+        };
+
+        template<size_t Lanes>
+        static constexpr void add(state<Lanes>& s, size_t lane, const Wide& value)
+        {
+            const Wide sum = s.sum[lane];
+            const Wide t = sum + value;
+            // only values are selected, without branches, so that the lanes can be vectorized
+            const bool sum_is_larger = (sum < 0 ? -sum : sum) >= (value < 0 ? -value : value);
+            const Wide larger = sum_is_larger ? sum : value;
+            const Wide smaller = sum_is_larger ? value : sum;
+            s.compensation[lane] += (larger - t) + smaller;
+            s.sum[lane] = t;
+        }
+
+        template<size_t Lanes>
+        static constexpr Wide total(const state<Lanes>& s)
+        {
+            state<1> all;
+            for(size_t i = 0; i < Lanes; ++i)
+                add(all, 0, s.sum[i]);
+            Wide compensation = all.compensation[0];
+            for(size_t i = 0; i < Lanes; ++i)
+                compensation += s.compensation[i];
+            return all.sum[0] + compensation;
+        }
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        constexpr auto default_accumulation_type()
+        {
+            if constexpr(std::is_floating_point_v<T>)
+                return std::conditional_t<(sizeof(T) > sizeof(double)), T, double>{};
+            else if constexpr(std::is_integral_v<T> && std::is_signed_v<T>)
+                return int64_t{};
+            else if constexpr(std::is_integral_v<T>)
+                return uint64_t{};
+            else
+                return T{};
+        }
+
+        template<typename T>
+        using default_accumulation = AccumulateWide<decltype(default_accumulation_type<T>())>;
+
+        /**
+         * Factor from the unit From to the unit To in the type Wide, integer types
+         * can only be used when the factor is an integer
+         */
+        template<typename From, typename To, typename Wide>
+        constexpr Wide accumulation_factor()
+        {
+            static_assert(std::is_same_v<typename From::Dimension, typename To::Dimension>,
+                          "Only quantities of the same dimension can be accumulated");
+            using Magnitude = MultiplyMagnitude<typename From::Magnitude, InverseMagnitude<typename To::Magnitude>>;
+            if constexpr(std::is_integral_v<Wide>)
+            {
+                constexpr magnitude_ratio_t ratio = magnitude_ratio<Magnitude>;
+                static_assert(ratio.is_rational && ratio.fits && ratio.den == 1,
+                              "Integers can only be accumulated from units whose factor is an integer");
+                return Wide(ratio.num);
+            }
+            else
+                return magnitude_factor<Magnitude, Wide>;
+        }
+    }
+
+    /**
+     * Sum of quantities of the dimension of Unit, expressed in Unit.
+     * The values are added in the type of Accumulation instead of T: AccumulateWide<Wide>
+     * adds in a wider type (double for floating point types, 64 bits integers for integers by default)
+     * and AccumulateCompensated<Wide> also compensates the rounding errors.
+     * Quantities of any unit of the same dimension can be added, the conversion factor is
+     * computed at compile time. Contiguous quantities are added on several independent lanes
+     * so that the loop can be vectorized.
+     * `units::quantity_accumulator<metre, float> total;`
+     * `total.add(distances_in_km);`
+     */
+    template<typename Unit, typename T = double, typename Accumulation = detail::default_accumulation<T>>
+    class quantity_accumulator
+    {
+    public:
+        using unit = Unit;
+        using value_type = T;
+        using accumulation_type = typename Accumulation::type;
+
+        static constexpr size_t lanes = 8;
+
+        constexpr quantity_accumulator() = default;
+
+        template<typename Unit2, typename T2, typename ApplyMagnitudePolicy>
+        constexpr quantity_accumulator& add(const quantity<Unit2, T2, ApplyMagnitudePolicy>& q)
+        {
+            constexpr accumulation_type factor = detail::accumulation_factor<Unit2, Unit, accumulation_type>();
+            const accumulation_type value = accumulation_type(detail::quantity_maker::value(q));
+            Accumulation::add(state_, 0, factor == accumulation_type(1) ? value : value * factor);
+            ++count_;
+            return *this;
+        }
+
+        /**
+         * Add n contiguous quantities
+         */
+        template<typename Unit2, typename T2, typename ApplyMagnitudePolicy>
+        quantity_accumulator& add(const quantity<Unit2, T2, ApplyMagnitudePolicy>* data, size_t n)
+        {
+            static_assert(detail::is_layout_compatible_quantity<quantity<Unit2, T2, ApplyMagnitudePolicy>>);
+            constexpr accumulation_type factor = detail::accumulation_factor<Unit2, Unit, accumulation_type>();
+            const T2* values = reinterpret_cast<const T2*>(data);
+            if constexpr(factor == accumulation_type(1))
+                add_values(values, n, [](const T2& value) { return accumulation_type(value); });
+            else
+                add_values(values, n, [](const T2& value) { return accumulation_type(value) * factor; });
+            return *this;
+        }
+
+        /**
+         * Add a contiguous range of quantities (std::vector, std::array, quantity_span, ...)
+         */
+        template<typename Range, typename = std::enable_if_t<!detail::is_quantity<Range>>>
+        quantity_accumulator& add(const Range& range)
+        {
+            return add(std::data(range), std::size(range));
+        }
+
+        template<typename Unit2, typename T2, typename ApplyMagnitudePolicy>
+        constexpr quantity_accumulator& operator+=(const quantity<Unit2, T2, ApplyMagnitudePolicy>& q)
+        {
+            return add(q);
+        }
+
+        /**
+         * Add the quantities of another accumulator, eg to combine partial sums made in parallel
+         */
+        template<typename Unit2, typename T2>
+        constexpr quantity_accumulator& merge(const quantity_accumulator<Unit2, T2, Accumulation>& other)
+        {
+            constexpr accumulation_type factor = detail::accumulation_factor<Unit2, Unit, accumulation_type>();
+            const accumulation_type value = other.value();
+            Accumulation::add(state_, 1, factor == accumulation_type(1) ? value : value * factor);
+            count_ += other.count();
+            return *this;
+        }
+
+        /**
+         * Number of quantities added
+         */
+        constexpr size_t count() const { return count_; }
+
+        /**
+         * Sum in the accumulation type
+         */
+        constexpr accumulation_type value() const { return Accumulation::total(state_); }
+
+        /**
+         * Sum as a quantity of Unit, rounded to T
+         */
+        constexpr quantity<Unit, T> total() const
+        {
+            return detail::quantity_maker::make<quantity<Unit, T>>(T(value()));
+        }
+
+        constexpr void reset() { *this = quantity_accumulator(); }
+
+    private:
+        template<typename T2, typename Convert>
+        void add_values(const T2* values, size_t n, Convert convert)
+        {
+            size_t i = 0;
+            for(; i + lanes <= n; i += lanes)
+                for(size_t lane = 0; lane < lanes; ++lane)
+                    Accumulation::add(state_, lane, convert(values[i + lane]));
+            for(size_t lane = 0; i < n; ++i, ++lane)
+                Accumulation::add(state_, lane, convert(values[i]));
+            count_ += n;
+        }
+
+        typename Accumulation::template state<lanes> state_;
+        size_t count_ = 0;
+    };
+}
+
+#endif // ACCUMULATOR_HPP
@@ -0,0 +1,171 @@
+#ifndef ATOMIC_QUANTITY_HPP
+#define ATOMIC_QUANTITY_HPP
+
+#include <atomic>
+#include <type_traits>
+#include "quantity.hpp"
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+
+namespace units
+{
+    /**
+     * Quantity that can be shared between threads, mirroring std::atomic<T>.
+     * Quantities of other units of the same dimension are converted to Unit before
+     * the atomic operation, with the factor computed at compile time.
+     * It is lock-free whenever std::atomic<T> is.
+     * `units::atomic_quantity<byte, int64_t> transferred;`
+     * `transferred.fetch_add(packet_size, std::memory_order_relaxed);`
+     */
+    template<typename Unit, typename T = double, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class atomic_quantity
+    {
+    public:
+        using unit = Unit;
+        using value_type = quantity<Unit, T, ApplyMagnitudePolicy>;
+
+        static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+        atomic_quantity() = default;
+
+        constexpr atomic_quantity(const value_type& q) : value_{detail::quantity_maker::value(q)} {}
+
+        atomic_quantity(const atomic_quantity&) = delete;
+        atomic_quantity& operator=(const atomic_quantity&) = delete;
+
+        bool is_lock_free() const { return value_.is_lock_free(); }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        void store(const quantity<Unit2, T2, Policy2>& q, std::memory_order order = std::memory_order_seq_cst)
+        {
+            value_.store(raw(q), order);
+        }
+
+        value_type load(std::memory_order order = std::memory_order_seq_cst) const
+        {
+            return make(value_.load(order));
+        }
+
+        operator value_type() const { return load(); }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type operator=(const quantity<Unit2, T2, Policy2>& q)
+        {
+            const T value = raw(q);
+            value_.store(value);
+            return make(value);
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type exchange(const quantity<Unit2, T2, Policy2>& q, std::memory_order order = std::memory_order_seq_cst)
+        {
+            return make(value_.exchange(raw(q), order));
+        }
+
+        /**
+         * expected is in Unit so that it can receive the current value when the exchange fails
+         */
+        template<typename Unit2, typename T2, typename Policy2>
+        bool compare_exchange_weak(value_type& expected, const quantity<Unit2, T2, Policy2>& desired,
+                                   std::memory_order success, std::memory_order failure)
+        {
+            return value_.compare_exchange_weak(raw_ref(expected), raw(desired), success, failure);
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        bool compare_exchange_weak(value_type& expected, const quantity<Unit2, T2, Policy2>& desired,
+                                   std::memory_order order = std::memory_order_seq_cst)
+        {
+            return value_.compare_exchange_weak(raw_ref(expected), raw(desired), order);
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        bool compare_exchange_strong(value_type& expected, const quantity<Unit2, T2, Policy2>& desired,
+                                     std::memory_order success, std::memory_order failure)
+        {
+            return value_.compare_exchange_strong(raw_ref(expected), raw(desired), success, failure);
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        bool compare_exchange_strong(value_type& expected, const quantity<Unit2, T2, Policy2>& desired,
+                                     std::memory_order order = std::memory_order_seq_cst)
+        {
+            return value_.compare_exchange_strong(raw_ref(expected), raw(desired), order);
+        }
+
+        /**
+         * Add q and return the previous value, floating point values are added with
+         * a compare and exchange loop before C++20
+         */
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type fetch_add(const quantity<Unit2, T2, Policy2>& q, std::memory_order order = std::memory_order_seq_cst)
+        {
+            return make(fetch_add_raw(raw(q), order));
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type fetch_sub(const quantity<Unit2, T2, Policy2>& q, std::memory_order order = std::memory_order_seq_cst)
+        {
+            return make(fetch_add_raw(T(-raw(q)), order));
+        }
+
+        /**
+         * Add q and return the new value
+         */
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type operator+=(const quantity<Unit2, T2, Policy2>& q)
+        {
+            const T value = raw(q);
+            return make(T(fetch_add_raw(value, std::memory_order_seq_cst) + value));
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        value_type operator-=(const quantity<Unit2, T2, Policy2>& q)
+        {
+            const T value = T(-raw(q));
+            return make(T(fetch_add_raw(value, std::memory_order_seq_cst) + value));
+        }
+
+    private:
+        static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be atomic");
+
+        static value_type make(T value) { return detail::quantity_maker::make<value_type>(value); }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        static T raw(const quantity<Unit2, T2, Policy2>& q)
+        {
+            static_assert(std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension>,
+                          "Only quantities of the same dimension can be stored in an atomic quantity");
+            if constexpr(std::is_same_v<Unit, Unit2> && std::is_same_v<T, T2>)
+                return detail::quantity_maker::value(q);
+            else
+                return T(q.in(Unit{}));
+        }
+
+        static T& raw_ref(value_type& q) { return detail::quantity_maker::value(q); }
+
+        T fetch_add_raw(T value, std::memory_order order)
+        {
+            #if defined(__cpp_lib_atomic_float)
+            return value_.fetch_add(value, order);
+            #else
+            if constexpr(std::is_integral_v<T>)
+                return value_.fetch_add(value, order);
+            else
+            {
+                T current = value_.load(std::memory_order_relaxed);
+                while(!value_.compare_exchange_weak(current, current + value, order, std::memory_order_relaxed))
+                    ;
+                return current;
+            }
+            #endif
+        }
+
+        std::atomic<T> value_{};
+    };
+}
+
+#endif // ATOMIC_QUANTITY_HPP
@@ -0,0 +1,120 @@
+#ifndef CHRONO_HPP
+#define CHRONO_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include "quantity.hpp"
+
+
+namespace units
+{
+    /**
+     * Whether Dimension is the time counted by std::chrono durations, whose base unit is the second.
+     * A base dimension opts in either by declaring a member
+     * `static constexpr bool is_time = true;`
+     * or by specializing this trait.
+     */
+    template<typename Dimension, typename = void>
+    struct is_time_dimension : std::false_type {};
+
+    template<typename Dimension>
+    struct is_time_dimension<Dimension, std::void_t<decltype(Dimension::is_time)>>
+        : std::bool_constant<Dimension::is_time> {};
+
+    template<typename Dimension>
+    inline constexpr bool is_time_dimension_v = is_time_dimension<Dimension>::value;
+
+    namespace detail
+    {
+        template<typename DimensionPower>
+        constexpr bool is_time_dimension_list(meta::typelist<DimensionPower>)
+        {
+            return DimensionPower::exponent == 1 && is_time_dimension_v<typename DimensionPower::Base>;
+        }
+
+        template<typename... DimensionPowers>
+        constexpr bool is_time_dimension_list(meta::typelist<DimensionPowers...>)
+        {
+            return false;
+        }
+
+        template<typename Unit>
+        inline constexpr bool is_time_unit = is_time_dimension_list(Unit::Dimension::typelist());
+
+        /**
+         * Apply Magnitude to value computed in the common type of T and To,
+         * exactly for integers like std::chrono::duration_cast
+         */
+        template<typename Magnitude, typename To, typename T>
+        constexpr To apply_chrono_magnitude(const T& value)
+        {
+            using Common = std::common_type_t<T, To>;
+            if constexpr(is_identity_magnitude<Magnitude>)
+                return static_cast<To>(value);
+            else
+                return static_cast<To>(ApplyMagnitudeAsRational::apply<Magnitude>(static_cast<Common>(value)));
+        }
+
+        template<typename Magnitude>
+        constexpr bool fits_in_ratio()
+        {
+            constexpr auto ratio = magnitude_ratio<Magnitude>;
+            constexpr auto max = static_cast<uint64_t>(INTMAX_MAX);
+            return ratio.is_rational && ratio.fits && ratio.num <= max && ratio.den <= max;
+        }
+
+        template<typename Magnitude>
+        using magnitude_as_ratio = std::ratio<static_cast<intmax_t>(magnitude_ratio<Magnitude>.num),
+                                              static_cast<intmax_t>(magnitude_ratio<Magnitude>.den)>;
+    }
+
+    /**
+     * Quantity of Unit with the value of a std::chrono::duration.
+     * Durations count in seconds, so Unit must be a unit of a time dimension (see is_time_dimension).
+     * The value keeps the representation of the duration and integers are converted
+     * exactly, truncated toward zero like std::chrono::duration_cast.
+     * When the period of the duration is the magnitude of Unit the count is only copied.
+     * `auto latency = units::from_duration<microsecond>(end - start);`
+     */
+    template<typename Unit, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat, typename Rep, typename Period>
+    constexpr quantity<Unit, Rep, ApplyMagnitudePolicy> from_duration(const std::chrono::duration<Rep, Period>& d)
+    {
+        static_assert(detail::is_unit<Unit>, "A duration can only be converted to a unit");
+        static_assert(detail::is_time_unit<Unit>, "A duration can only be converted to a unit of time");
+        using Magnitude = MultiplyMagnitude<MagnitudeFromRatio<typename Period::type>,
+                                            InverseMagnitude<typename Unit::Magnitude>>;
+        return detail::quantity_maker::make<quantity<Unit, Rep, ApplyMagnitudePolicy>>(
+            detail::apply_chrono_magnitude<Magnitude, Rep>(d.count()));
+    }
+
+    /**
+     * Duration with the value of a quantity of time, see from_duration.
+     * `std::this_thread::sleep_for(units::to_duration<std::chrono::milliseconds>(timeout));`
+     */
+    template<typename Duration, typename Unit, typename T, typename ApplyMagnitudePolicy>
+    constexpr Duration to_duration(const quantity<Unit, T, ApplyMagnitudePolicy>& q)
+    {
+        static_assert(detail::is_time_unit<Unit>, "Only a quantity of time can be converted to a duration");
+        using Magnitude = MultiplyMagnitude<typename Unit::Magnitude,
+                                            InverseMagnitude<MagnitudeFromRatio<typename Duration::period>>>;
+        return Duration(detail::apply_chrono_magnitude<Magnitude, typename Duration::rep>(
+            detail::quantity_maker::value(q)));
+    }
+
+    /**
+     * Duration whose period is the magnitude of Unit, the value is only copied
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+    constexpr auto to_duration(const quantity<Unit, T, ApplyMagnitudePolicy>& q)
+    {
+        static_assert(detail::is_time_unit<Unit>, "Only a quantity of time can be converted to a duration");
+        static_assert(detail::fits_in_ratio<typename Unit::Magnitude>(),
+                      "The magnitude of the unit cannot be represented by a std::ratio");
+        using Duration = std::chrono::duration<T, detail::magnitude_as_ratio<typename Unit::Magnitude>>;
+        return Duration(detail::quantity_maker::value(q));
+    }
+}
+
+#endif // CHRONO_HPP
@@ -0,0 +1,610 @@
+#ifndef COLUMN_FILE_HPP
+#define COLUMN_FILE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "convert.hpp"
+#include "quantity_span.hpp"
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UNITS_COLUMN_FILE_MMAP 1
+#else
+#define UNITS_COLUMN_FILE_MMAP 0
+#endif
+
+
+/**
+ * Columnar file format for quantities
+ *
+ * A file holds columns of the same number of rows, each column stores raw values
+ * of an arithmetic type together with the unit they are expressed in: the base
+ * dimensions and the factors of the magnitude, raised to their exponents.
+ * Base dimensions and irrational factors are identified by their ordinal, which they
+ * must have (see meta::ordinal): type names differ between compilers, so a file written
+ * by one build would be rejected by another.
+ * The rows are grouped in blocks, and the minimum and maximum of each block are stored.
+ *
+ * Layout, in native byte order:
+ *   column_file_header
+ *   column_header x column_count
+ *   for each column, aligned on column_file_alignment: the values, then the zone map (min, max for each block)
+ */
+namespace units
+{
+    enum class column_file_error
+    {
+        none,
+        io_error,
+        bad_format,
+        missing_column,
+        name_too_long,
+        row_count_mismatch,
+        element_type_mismatch,
+        dimension_mismatch,
+        magnitude_mismatch,
+    };
+
+    namespace detail
+    {
+        inline constexpr char column_file_magic[8] = {'U', 'N', 'I', 'T', 'S', 'C', 'O', 'L'};
+        inline constexpr uint32_t column_file_version = 1;
+        inline constexpr uint32_t column_file_byte_order = 0x01020304;
+        inline constexpr size_t column_file_alignment = 64;
+        inline constexpr size_t column_name_capacity = 48;
+        inline constexpr size_t column_term_capacity = 16;
+
+        enum class column_term_kind : uint32_t
+        {
+            dimension_ordinal = 1,
+            prime_factor = 2,
+            irrational_ordinal = 3,
+        };
+
+        struct column_term
+        {
+            column_term_kind kind;
+            int32_t exponent;
+            uint64_t id;
+
+            constexpr bool operator==(const column_term& other) const
+            {
+                return kind == other.kind && exponent == other.exponent && id == other.id;
+            }
+        };
+
+        struct column_signature
+        {
+            uint32_t dimension_count = 0;
+            uint32_t magnitude_count = 0;
+            column_term terms[column_term_capacity] = {};
+
+            constexpr bool same_dimension(const column_signature& other) const
+            {
+                if(dimension_count != other.dimension_count)
+                    return false;
+                for(uint32_t i = 0; i < dimension_count; ++i)
+                    if(!(terms[i] == other.terms[i]))
+                        return false;
+                return true;
+            }
+
+            constexpr bool same_magnitude(const column_signature& other) const
+            {
+                if(magnitude_count != other.magnitude_count)
+                    return false;
+                for(uint32_t i = dimension_count; i < dimension_count + magnitude_count; ++i)
+                    if(!(terms[i] == other.terms[i - dimension_count + other.dimension_count]))
+                        return false;
+                return true;
+            }
+        };
+
+        struct column_file_header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint64_t rows;
+            uint64_t block_rows;
+            uint64_t column_count;
+        };
+
+        struct column_header
+        {
+            char name[column_name_capacity];
+            uint32_t element_type;
+            uint32_t element_size;
+            uint64_t data_offset;
+            uint64_t zone_map_offset;
+            column_signature unit;
+        };
+
+        template<typename T>
+        constexpr column_term make_column_term(column_term_kind kind, int exponent)
+        {
+            static_assert(meta::has_ordinal_v<T>,
+                          "Base dimensions and irrational factors of a stored unit need an ordinal");
+            return {kind, exponent, meta::ordinal<T>::value};
+        }
+
+        template<typename FactorPower>
+        constexpr column_term make_factor_term()
+        {
+            using Factor = typename FactorPower::Base;
+            if constexpr(is_int_factor<Factor>)
+                return {column_term_kind::prime_factor, FactorPower::exponent, static_cast<uint64_t>(Factor::value)};
+            else
+                return make_column_term<Factor>(column_term_kind::irrational_ordinal, FactorPower::exponent);
+        }
+
+        template<typename... DimensionPowers, typename... FactorPowers>
+        constexpr column_signature make_column_signature_impl(meta::typelist<DimensionPowers...>,
+                                                              const magnitude_raw<FactorPowers...>&)
+        {
+            static_assert(sizeof...(DimensionPowers) + sizeof...(FactorPowers) <= column_term_capacity,
+                          "Unit too complex to be stored in a column file");
+            column_signature signature;
+            signature.dimension_count = sizeof...(DimensionPowers);
+            signature.magnitude_count = sizeof...(FactorPowers);
+            size_t i = 0;
+            ((signature.terms[i++] = make_column_term<typename DimensionPowers::Base>(
+                column_term_kind::dimension_ordinal, DimensionPowers::exponent)), ...);
+            ((signature.terms[i++] = make_factor_term<FactorPowers>()), ...);
+            return signature;
+        }
+
+        template<typename... DimensionPowers, typename... FactorPowers>
+        constexpr bool has_stable_signature_impl(meta::typelist<DimensionPowers...>,
+                                                 const magnitude_raw<FactorPowers...>&)
+        {
+            return (meta::has_ordinal_v<typename DimensionPowers::Base> && ...) &&
+                   ((is_int_factor<typename FactorPowers::Base> || meta::has_ordinal_v<typename FactorPowers::Base>) &&
+                    ...);
+        }
+
+        /**
+         * Whether the base dimensions and irrational factors of Unit all have an ordinal,
+         * so that its signature is the same with every compiler
+         */
+        template<typename Unit>
+        inline constexpr bool has_stable_signature =
+            has_stable_signature_impl(Unit::Dimension::typelist(), typename Unit::Magnitude{});
+
+        /**
+         * Description of a unit as stored in a column file
+         */
+        template<typename Unit>
+        inline constexpr column_signature column_signature_of =
+            make_column_signature_impl(Unit::Dimension::typelist(), typename Unit::Magnitude{});
+
+        /**
+         * Code of an element type in a column file: its kind followed by its size
+         */
+        template<typename T>
+        constexpr uint32_t column_element_type()
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic types can be stored in a column file");
+            constexpr uint32_t kind = std::is_floating_point_v<T> ? 'f' : std::is_signed_v<T> ? 'i' : 'u';
+            return kind << 8u | uint32_t(sizeof(T));
+        }
+
+        constexpr uint64_t align_up(uint64_t offset)
+        {
+            return (offset + column_file_alignment - 1) / column_file_alignment * column_file_alignment;
+        }
+
+        /**
+         * Read only view of a whole file, mapped in memory when the platform allows it
+         * and read in a buffer otherwise
+         */
+        class mapped_file
+        {
+        public:
+            mapped_file() = default;
+
+            mapped_file(const mapped_file&) = delete;
+
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            mapped_file(mapped_file&& other) noexcept { swap(other); }
+
+            mapped_file& operator=(mapped_file&& other) noexcept
+            {
+                mapped_file(std::move(other)).swap(*this);
+                return *this;
+            }
+
+            ~mapped_file() { close(); }
+
+            bool open(const std::string& path)
+            {
+                close();
+            #if UNITS_COLUMN_FILE_MMAP
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if(fd < 0)
+                    return false;
+                struct stat status{};
+                bool ok = ::fstat(fd, &status) == 0 && status.st_size > 0;
+                if(ok)
+                {
+                    void* address = ::mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                    ok = address != MAP_FAILED;
+                    if(ok)
+                    {
+                        data_ = static_cast<const std::byte*>(address);
+                        size_ = size_t(status.st_size);
+                    }
+                }
+                ::close(fd);
+                return ok;
+            #else
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if(!file)
+                    return false;
+                buffer_.resize(size_t(file.tellg()));
+                file.seekg(0);
+                if(!file.read(reinterpret_cast<char*>(buffer_.data()), std::streamsize(buffer_.size())))
+                    return false;
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+                return true;
+            #endif
+            }
+
+            void close()
+            {
+            #if UNITS_COLUMN_FILE_MMAP
+                if(data_)
+                    ::munmap(const_cast<std::byte*>(data_), size_);
+            #else
+                buffer_.clear();
+            #endif
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            const std::byte* data() const { return data_; }
+
+            size_t size() const { return size_; }
+
+        private:
+            void swap(mapped_file& other) noexcept
+            {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+            #if !UNITS_COLUMN_FILE_MMAP
+                std::swap(buffer_, other.buffer_);
+            #endif
+            }
+
+            const std::byte* data_ = nullptr;
+            size_t size_ = 0;
+        #if !UNITS_COLUMN_FILE_MMAP
+            std::vector<std::byte> buffer_;
+        #endif
+        };
+    }
+
+    /**
+     * Write columns of quantities in a column file.
+     * The values are not copied, they must stay alive until write() is called.
+     */
+    class column_file_writer
+    {
+    public:
+        explicit column_file_writer(size_t block_rows = 65536) : block_rows_{block_rows}
+        {
+            assert(block_rows > 0);
+        }
+
+        /**
+         * Add a column of raw values expressed in Unit.
+         * The name must be shorter than 48 bytes and every column must have the same
+         * number of rows, otherwise the column is not added.
+         */
+        template<typename Unit, typename T>
+        column_file_error add_column(std::string_view name, const T* values, size_t rows)
+        {
+            if(name.size() >= detail::column_name_capacity)
+                return column_file_error::name_too_long;
+            if(!columns_.empty() && rows != rows_)
+                return column_file_error::row_count_mismatch;
+            rows_ = rows;
+
+            pending_column column{};
+            std::memcpy(column.header.name, name.data(), name.size());
+            column.header.element_type = detail::column_element_type<T>();
+            column.header.element_size = sizeof(T);
+            column.header.unit = detail::column_signature_of<Unit>;
+            column.values = reinterpret_cast<const std::byte*>(values);
+
+            for(size_t first = 0; first < rows; first += block_rows_)
+            {
+                const auto [min, max] = std::minmax_element(values + first, values + std::min(rows, first + block_rows_));
+                column.zone_map.insert(column.zone_map.end(), reinterpret_cast<const std::byte*>(min),
+                                       reinterpret_cast<const std::byte*>(min) + sizeof(T));
+                column.zone_map.insert(column.zone_map.end(), reinterpret_cast<const std::byte*>(max),
+                                       reinterpret_cast<const std::byte*>(max) + sizeof(T));
+            }
+            columns_.push_back(std::move(column));
+            return column_file_error::none;
+        }
+
+        template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+        column_file_error add_column(std::string_view name, const quantity<Unit, T, ApplyMagnitudePolicy>* values,
+                                     size_t rows)
+        {
+            return add_column<Unit>(name, reinterpret_cast<const T*>(values), rows);
+        }
+
+        template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+        column_file_error add_column(std::string_view name, quantity_span<Unit, T, ApplyMagnitudePolicy> values)
+        {
+            return add_column<Unit>(name, values.raw().data(), values.size());
+        }
+
+        column_file_error write(const std::string& path)
+        {
+            detail::column_file_header header{};
+            std::memcpy(header.magic, detail::column_file_magic, sizeof(header.magic));
+            header.version = detail::column_file_version;
+            header.byte_order = detail::column_file_byte_order;
+            header.rows = rows_;
+            header.block_rows = block_rows_;
+            header.column_count = columns_.size();
+
+            uint64_t offset = sizeof(header) + columns_.size() * sizeof(detail::column_header);
+            for(auto& column : columns_)
+            {
+                column.header.data_offset = detail::align_up(offset);
+                column.header.zone_map_offset = detail::align_up(column.header.data_offset + data_size(column));
+                offset = column.header.zone_map_offset + column.zone_map.size();
+            }
+
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            uint64_t position = 0;
+            auto put = [&](const void* data, size_t size)
+            {
+                file.write(static_cast<const char*>(data), std::streamsize(size));
+                position += size;
+            };
+            auto pad_to = [&](uint64_t target)
+            {
+                static constexpr char zeros[detail::column_file_alignment] = {};
+                put(zeros, target - position);
+            };
+
+            put(&header, sizeof(header));
+            for(const auto& column : columns_)
+                put(&column.header, sizeof(column.header));
+            for(const auto& column : columns_)
+            {
+                pad_to(column.header.data_offset);
+                put(column.values, data_size(column));
+                pad_to(column.header.zone_map_offset);
+                put(column.zone_map.data(), column.zone_map.size());
+            }
+            file.close();
+            return file ? column_file_error::none : column_file_error::io_error;
+        }
+
+    private:
+        struct pending_column
+        {
+            detail::column_header header;
+            const std::byte* values;
+            std::vector<std::byte> zone_map;
+        };
+
+        uint64_t data_size(const pending_column& column) const { return rows_ * column.header.element_size; }
+
+        size_t block_rows_;
+        size_t rows_ = 0;
+        std::vector<pending_column> columns_;
+    };
+
+    /**
+     * Column expected by a column_file_reader: values read as quantities of Unit
+     * with type T from a column stored in StoredUnit.
+     * The factor between StoredUnit and Unit is known at compile time, a column
+     * that is not stored in StoredUnit is rejected when the file is opened.
+     */
+    template<typename Unit, typename T, typename StoredUnit = Unit,
+             typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    struct column
+    {
+        static_assert(std::is_same_v<typename Unit::Dimension, typename StoredUnit::Dimension>,
+                      "Cannot read a column in a unit of a different dimension");
+    };
+
+    /**
+     * Read access to one column of a column file.
+     * When the stored unit is the requested one, the values are viewed in place,
+     * otherwise each block is converted when it is accessed.
+     */
+    template<typename Unit, typename T, typename StoredUnit = Unit,
+             typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class column_view
+    {
+    public:
+        using unit = Unit;
+        using stored_unit = StoredUnit;
+        using value_type = quantity<Unit, T, ApplyMagnitudePolicy>;
+        using values_span = quantity_span<Unit, const T, ApplyMagnitudePolicy>;
+
+        static constexpr bool zero_copy =
+            std::is_same_v<typename Unit::Magnitude, typename StoredUnit::Magnitude>;
+
+        column_view(const T* values, const T* zone_map, size_t rows, size_t block_rows) :
+            values_{values}, zone_map_{zone_map}, rows_{rows}, block_rows_{block_rows}
+        {}
+
+        size_t size() const { return rows_; }
+
+        size_t block_rows() const { return block_rows_; }
+
+        size_t block_count() const { return (rows_ + block_rows_ - 1) / block_rows_; }
+
+        /**
+         * All the values, only available when they are stored in Unit
+         */
+        values_span values() const
+        {
+            static_assert(zero_copy, "The column is not stored in the requested unit, access it by block");
+            return values_span(values_, rows_);
+        }
+
+        /**
+         * Values of a block, converted on first access when they are not stored in Unit.
+         * The view is valid until the next call.
+         */
+        values_span block(size_t index)
+        {
+            assert(index < block_count());
+            const size_t first = index * block_rows_;
+            const size_t count = std::min(rows_ - first, block_rows_);
+            if constexpr(zero_copy)
+                return values_span(values_ + first, count);
+            else
+            {
+                if(cached_block_ != index)
+                {
+                    cache_.resize(count);
+                    convert_values<StoredUnit, Unit, ApplyMagnitudePolicy>(values_ + first, cache_.data(), count);
+                    cached_block_ = index;
+                }
+                return values_span(cache_.data(), count);
+            }
+        }
+
+        value_type block_min(size_t index) const { return zone_map_value(2 * index); }
+
+        value_type block_max(size_t index) const { return zone_map_value(2 * index + 1); }
+
+    private:
+        value_type zone_map_value(size_t index) const
+        {
+            // magnitudes are positive so the conversion keeps the order
+            using Stored = quantity<StoredUnit, T, ApplyMagnitudePolicy>;
+            return detail::quantity_maker::make<Stored>(zone_map_[index]).template as<Unit>();
+        }
+
+        const T* values_;
+        const T* zone_map_;
+        size_t rows_;
+        size_t block_rows_;
+        std::vector<T> cache_;
+        size_t cached_block_ = size_t(-1);
+    };
+
+    /**
+     * Read a column file with an expected schema, each column is described with units::column.
+     * The file is memory mapped and every column is checked when it is opened, the
+     * columns are then accessed by index with no further check.
+     * `units::column_file_reader<units::column<metre, float>, units::column<second, double, millisecond>> reader;`
+     * `if(reader.open(path, {"altitude", "duration"}) == units::column_file_error::none) ...`
+     */
+    template<typename... Columns>
+    class column_file_reader;
+
+    template<typename... Units, typename... Ts, typename... StoredUnits, typename... ApplyMagnitudePolicies>
+    class column_file_reader<column<Units, Ts, StoredUnits, ApplyMagnitudePolicies>...>
+    {
+        static constexpr size_t column_count = sizeof...(Units);
+
+        template<size_t I>
+        using column_at = std::tuple_element_t<I, std::tuple<column_view<Units, Ts, StoredUnits, ApplyMagnitudePolicies>...>>;
+
+    public:
+        column_file_error open(const std::string& path, const std::array<std::string_view, column_count>& names)
+        {
+            header_ = nullptr;
+            if(!file_.open(path))
+                return column_file_error::io_error;
+            if(file_.size() < sizeof(detail::column_file_header))
+                return column_file_error::bad_format;
+
+            const auto* header = reinterpret_cast<const detail::column_file_header*>(file_.data());
+            if(std::memcmp(header->magic, detail::column_file_magic, sizeof(header->magic)) != 0 ||
+               header->version != detail::column_file_version ||
+               header->byte_order != detail::column_file_byte_order ||
+               header->block_rows == 0 ||
+               header->column_count > (file_.size() - sizeof(*header)) / sizeof(detail::column_header))
+                return column_file_error::bad_format;
+            const auto* columns = reinterpret_cast<const detail::column_header*>(header + 1);
+
+            column_file_error error = column_file_error::none;
+            size_t i = 0;
+            ((error = error == column_file_error::none
+                ? find_column<Ts, StoredUnits>(*header, columns, names[i], columns_[i]) : error, ++i), ...);
+            if(error == column_file_error::none)
+                header_ = header;
+            return error;
+        }
+
+        size_t rows() const { return header_ ? header_->rows : 0; }
+
+        template<size_t I>
+        column_at<I> get() const
+        {
+            assert(header_);
+            using T = typename column_at<I>::value_type::value_type;
+            const detail::column_header& column = *columns_[I];
+            return column_at<I>(reinterpret_cast<const T*>(file_.data() + column.data_offset),
+                                reinterpret_cast<const T*>(file_.data() + column.zone_map_offset),
+                                header_->rows, header_->block_rows);
+        }
+
+    private:
+        template<typename T, typename StoredUnit>
+        column_file_error find_column(const detail::column_file_header& header, const detail::column_header* columns,
+                                      std::string_view name, const detail::column_header*& found) const
+        {
+            const auto* end = columns + header.column_count;
+            const auto* column = std::find_if(columns, end, [&](const detail::column_header& column)
+            {
+                const char* name_end = std::find(column.name, column.name + sizeof(column.name), '\0');
+                return std::string_view(column.name, size_t(name_end - column.name)) == name;
+            });
+            if(column == end)
+                return column_file_error::missing_column;
+            if(column->element_type != detail::column_element_type<T>() || column->element_size != sizeof(T))
+                return column_file_error::element_type_mismatch;
+
+            const uint64_t blocks = (header.rows + header.block_rows - 1) / header.block_rows;
+            if(column->data_offset % alignof(T) != 0 || column->zone_map_offset % alignof(T) != 0 ||
+               column->data_offset > file_.size() || header.rows > (file_.size() - column->data_offset) / sizeof(T) ||
+               column->zone_map_offset > file_.size() ||
+               blocks * 2 > (file_.size() - column->zone_map_offset) / sizeof(T) ||
+               column->unit.dimension_count + column->unit.magnitude_count > detail::column_term_capacity)
+                return column_file_error::bad_format;
+
+            constexpr detail::column_signature expected = detail::column_signature_of<StoredUnit>;
+            if(!column->unit.same_dimension(expected))
+                return column_file_error::dimension_mismatch;
+            if(!column->unit.same_magnitude(expected))
+                return column_file_error::magnitude_mismatch;
+            found = column;
+            return column_file_error::none;
+        }
+
+        detail::mapped_file file_;
+        const detail::column_file_header* header_ = nullptr;
+        std::array<const detail::column_header*, column_count> columns_{};
+    };
+}
+
+#endif // COLUMN_FILE_HPP
@@ -0,0 +1,317 @@
+#ifndef CONVERT_HPP
+#define CONVERT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include "quantity.hpp"
+
+#if(defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define UNITS_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define UNITS_SIMD_X86 0
+#endif
+
+
+namespace units
+{
+    namespace detail
+    {
+        namespace simd
+        {
+            enum struct isa : int
+            {
+                scalar, sse2, avx2, avx512
+            };
+
+            /**
+             * Best instruction set supported by the CPU, detected once
+             */
+            inline isa best_isa()
+            {
+                #if UNITS_SIMD_X86
+                static const isa best = []
+                {
+                    __builtin_cpu_init();
+                    if(__builtin_cpu_supports("avx512f"))
+                        return isa::avx512;
+                    else if(__builtin_cpu_supports("avx2"))
+                        return isa::avx2;
+                    else if(__builtin_cpu_supports("sse2"))
+                        return isa::sse2;
+                    else
+                        return isa::scalar;
+                }();
+                return best;
+                #else
+                return isa::scalar;
+                #endif
+            }
+
+            /**
+             * out[i] = T(factor * Factor(in[i])), in and out may be the same buffer
+             */
+            template<typename T, typename Factor>
+            inline void scale_scalar(const T* in, T* out, size_t n, Factor factor)
+            {
+                for(size_t i = 0; i < n; ++i)
+                    out[i] = T(factor * Factor(in[i]));
+            }
+
+            #if UNITS_SIMD_X86
+
+            // Each kernel handles as many full vectors as possible and returns how many
+            // elements it has processed, the scalar loop does the rest
+
+            __attribute__((target("sse2")))
+            inline size_t scale_sse2(const float* in, float* out, size_t n, float factor)
+            {
+                const __m128 f = _mm_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), f));
+                return i;
+            }
+
+            __attribute__((target("avx2")))
+            inline size_t scale_avx2(const float* in, float* out, size_t n, float factor)
+            {
+                const __m256 f = _mm256_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), f));
+                return i;
+            }
+
+            __attribute__((target("avx512f")))
+            inline size_t scale_avx512(const float* in, float* out, size_t n, float factor)
+            {
+                const __m512 f = _mm512_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 16 <= n; i += 16)
+                    _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(in + i), f));
+                return i;
+            }
+
+            __attribute__((target("sse2")))
+            inline size_t scale_sse2(const double* in, double* out, size_t n, double factor)
+            {
+                const __m128d f = _mm_set1_pd(factor);
+                size_t i = 0;
+                for(; i + 2 <= n; i += 2)
+                    _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(in + i), f));
+                return i;
+            }
+
+            __attribute__((target("avx2")))
+            inline size_t scale_avx2(const double* in, double* out, size_t n, double factor)
+            {
+                const __m256d f = _mm256_set1_pd(factor);
+                size_t i = 0;
+                for(; i + 4 <= n; i += 4)
+                    _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(in + i), f));
+                return i;
+            }
+
+            __attribute__((target("avx512f")))
+            inline size_t scale_avx512(const double* in, double* out, size_t n, double factor)
+            {
+                const __m512d f = _mm512_set1_pd(factor);
+                size_t i = 0;
+                for(; i + 8 <= n; i += 8)
+                    _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(in + i), f));
+                return i;
+            }
+
+            // int32 values scaled through float, then truncated, like ApplyMagnitudeAsFloat
+
+            __attribute__((target("sse2")))
+            inline size_t scale_sse2(const int32_t* in, int32_t* out, size_t n, float factor)
+            {
+                const __m128 f = _mm_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 4 <= n; i += 4)
+                {
+                    const __m128 values = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvttps_epi32(_mm_mul_ps(values, f)));
+                }
+                return i;
+            }
+
+            __attribute__((target("avx2")))
+            inline size_t scale_avx2(const int32_t* in, int32_t* out, size_t n, float factor)
+            {
+                const __m256 f = _mm256_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 8 <= n; i += 8)
+                {
+                    const __m256 values = _mm256_cvtepi32_ps(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                        _mm256_cvttps_epi32(_mm256_mul_ps(values, f)));
+                }
+                return i;
+            }
+
+            __attribute__((target("avx512f")))
+            inline size_t scale_avx512(const int32_t* in, int32_t* out, size_t n, float factor)
+            {
+                const __m512 f = _mm512_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 16 <= n; i += 16)
+                {
+                    const __m512 values = _mm512_cvtepi32_ps(_mm512_loadu_si512(in + i));
+                    _mm512_storeu_si512(out + i, _mm512_cvttps_epi32(_mm512_mul_ps(values, f)));
+                }
+                return i;
+            }
+
+            // int64 values scaled through float, only AVX-512DQ converts between int64 and float
+
+            inline bool has_avx512dq()
+            {
+                static const bool supported = []
+                {
+                    __builtin_cpu_init();
+                    return __builtin_cpu_supports("avx512dq") != 0;
+                }();
+                return supported;
+            }
+
+            __attribute__((target("avx512f,avx512dq")))
+            inline size_t scale_avx512dq(const int64_t* in, int64_t* out, size_t n, float factor)
+            {
+                const __m256 f = _mm256_set1_ps(factor);
+                size_t i = 0;
+                for(; i + 8 <= n; i += 8)
+                {
+                    const __m256 values = _mm512_cvtepi64_ps(_mm512_loadu_si512(in + i));
+                    _mm512_storeu_si512(out + i, _mm512_cvttps_epi64(_mm256_mul_ps(values, f)));
+                }
+                return i;
+            }
+
+            template<typename T, typename Factor, typename = void>
+            struct has_kernel : std::false_type {};
+
+            template<typename T, typename Factor>
+            struct has_kernel<T, Factor, std::void_t<decltype(
+                scale_sse2(std::declval<const T*>(), std::declval<T*>(), size_t(), std::declval<Factor>()))>>
+                : std::true_type {};
+
+            #endif
+
+            /**
+             * out[i] = T(factor * Factor(in[i])) with the best kernel available
+             * in and out may be the same buffer
+             */
+            template<typename T, typename Factor>
+            inline void scale(const T* in, T* out, size_t n, Factor factor)
+            {
+                size_t done = 0;
+                #if UNITS_SIMD_X86
+                if constexpr(has_kernel<T, Factor>::value)
+                {
+                    switch(best_isa())
+                    {
+                        case isa::avx512:
+                            done = scale_avx512(in, out, n, factor);
+                            break;
+                        case isa::avx2:
+                            done = scale_avx2(in, out, n, factor);
+                            break;
+                        case isa::sse2:
+                            done = scale_sse2(in, out, n, factor);
+                            break;
+                        case isa::scalar:
+                            break;
+                    }
+                }
+                else if constexpr(std::is_same_v<T, int64_t> && std::is_same_v<Factor, float>)
+                {
+                    if(has_avx512dq())
+                        done = scale_avx512dq(in, out, n, factor);
+                }
+                #endif
+                scale_scalar(in + done, out + done, n - done, factor);
+            }
+        }
+    }
+
+    /**
+     * Convert n values from the unit From to the unit To, in and out may be the same buffer.
+     *
+     * With ApplyMagnitudeAsFloat on arithmetic types the constant factor of the conversion
+     * is applied with SIMD kernels selected at runtime, except on integers scaled by a power
+     * of two which are shifted. Other policies apply the magnitude element by element.
+     */
+    template<typename From, typename To, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat, typename T>
+    void convert_values(const T* in, T* out, size_t n)
+    {
+        static_assert(std::is_same_v<typename From::Dimension, typename To::Dimension>,
+                      "Cannot convert between units of different dimensions");
+        using MagnitudeToApply = MultiplyMagnitude<typename From::Magnitude, InverseMagnitude<typename To::Magnitude>>;
+        using AccumulationType = decltype(std::declval<T>() * std::declval<float>());
+
+        if constexpr(detail::is_identity_magnitude<MagnitudeToApply>)
+        {
+            if(in != out && n > 0)
+                std::memmove(out, in, n * sizeof(T));
+        }
+        else if constexpr(std::is_same_v<ApplyMagnitudePolicy, ApplyMagnitudeAsFloat> &&
+                          std::is_arithmetic_v<T> && std::is_floating_point_v<AccumulationType> &&
+                          !(std::is_integral_v<T> && detail::power_of_two_magnitude<MagnitudeToApply>::value))
+        {
+            detail::simd::scale(in, out, n, detail::magnitude_factor<MagnitudeToApply, AccumulationType>);
+        }
+        else
+        {
+            for(size_t i = 0; i < n; ++i)
+                out[i] = T(ApplyMagnitudePolicy::template apply<MagnitudeToApply>(in[i]));
+        }
+    }
+
+    /**
+     * Convert n quantities to the unit To
+     */
+    template<typename To, typename From, typename T, typename ApplyMagnitudePolicy>
+    void convert(const quantity<From, T, ApplyMagnitudePolicy>* in, quantity<To, T, ApplyMagnitudePolicy>* out, size_t n)
+    {
+        static_assert(detail::is_layout_compatible_quantity<quantity<From, T, ApplyMagnitudePolicy>>);
+        convert_values<From, To, ApplyMagnitudePolicy>(reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out), n);
+    }
+
+    /**
+     * Convert a contiguous range of quantities (std::vector, std::array, std::span, ...)
+     * into another one. Only as many quantities as both ranges hold are converted,
+     * their number is returned.
+     */
+    template<typename InputRange, typename OutputRange>
+    size_t convert(const InputRange& in, OutputRange&& out)
+    {
+        using Out = std::remove_reference_t<decltype(*std::data(out))>;
+        const size_t n = std::min<size_t>(std::size(in), std::size(out));
+        convert<typename Out::unit>(std::data(in), std::data(out), n);
+        return n;
+    }
+
+    /**
+     * Convert n quantities to the unit To in place.
+     * The returned pointer gives access to the converted quantities.
+     */
+    template<typename To, typename From, typename T, typename ApplyMagnitudePolicy>
+    quantity<To, T, ApplyMagnitudePolicy>* convert_in_place(quantity<From, T, ApplyMagnitudePolicy>* data, size_t n)
+    {
+        static_assert(detail::is_layout_compatible_quantity<quantity<From, T, ApplyMagnitudePolicy>>);
+        T* values = reinterpret_cast<T*>(data);
+        convert_values<From, To, ApplyMagnitudePolicy>(values, values, n);
+        return reinterpret_cast<quantity<To, T, ApplyMagnitudePolicy>*>(values);
+    }
+}
+
+#undef UNITS_SIMD_X86
+
+#endif // CONVERT_HPP
@@ -4,7 +4,7 @@
 #include "power.hpp"
 #include "downcast.hpp"
 #include "meta.hpp"
-#include "type_name.hpp"
+#include "ordinal.hpp"
 
 
 namespace units
@@ -62,6 +62,12 @@ namespace units
      * Usage is as follow:
      * `struct Length : BaseDimension<Length> {};`
      * Length is now a new base dimension
+     * 
+     * A base dimension can declare a `static constexpr uint64_t ordinal` member
+     * (see meta::ordinal), it is then ordered by it instead of by its type name,
+     * which gives the same dimension types on every compiler:
+     * `struct Length : BaseDimension<Length> { static constexpr uint64_t ordinal = 1; };`
+     * Dimensions that are stored, eg in a column file, must have one.
      */
     template<typename Child>
     using BaseDimension = detail::named_dimension<Child, detail::dimension_raw<Power<Child, 1>>>;
@@ -70,34 +76,33 @@ namespace units
     {
         struct DimensionComparator
         {
+            // Compare the dimension types by there ordinal if they have one,
+            // by there type names otherwise
+            using key_type = meta::type_key;
+
+            template<typename PowDimType>
+            static constexpr key_type key(const PowDimType&)
+            {
+                using Dim = typename PowDimType::type::Base;
+                return meta::make_type_key<Dim>();
+            }
+
             template<typename PowDimType1, typename PowDimType2>
             constexpr auto operator()(const PowDimType1&,
                                       const PowDimType2&) const
             {
-                using PowDim1 = typename PowDimType1::type;
-                using PowDim2 = typename PowDimType2::type;
-                using Dim1 = typename PowDim1::Base;
-                using Dim2 = typename PowDim2::Base;
-                // Compare the dimension types by there type names
-                constexpr auto dim1Name = meta::type_name<Dim1>();
-                constexpr auto dim2Name = meta::type_name<Dim2>();
-                if constexpr(dim1Name == dim2Name)
-                    return meta::val<meta::ordering::equivalent>;
-                else if constexpr(dim1Name < dim2Name)
-                    return meta::val<meta::ordering::less>;
-                else
-                    return meta::val<meta::ordering::greater>;
+                return meta::val<meta::compare_keys(key(PowDimType1{}), key(PowDimType2{}))>;
             }
         };
 
         template<typename DimensionPower>
         constexpr auto to_base_dimensions()
         {
-            constexpr int exp_to_multiply = DimensionPower::exponent;
             using dim_raw = typename DimensionPower::Base;
             auto base_dimensions = dim_raw::typelist();
             auto pow_multiplier = [](auto dim_power_type)
             {
+                constexpr int exp_to_multiply = DimensionPower::exponent;
                 using DimPower = typename decltype(dim_power_type)::type;
                 using BaseDim = typename DimPower::Base;
                 constexpr auto exp = DimPower::exponent;
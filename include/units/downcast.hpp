@@ -6,6 +6,12 @@
 
 namespace meta
 {
+    #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    // The friend is intentionally a non-template function, it is defined by downcast_child
+    #pragma GCC diagnostic ignored "-Wnon-template-friend"
+    #endif
+
     template<typename BaseType>
     struct downcast_base
     {
@@ -13,6 +19,10 @@ namespace meta
         friend auto downcast_guide(downcast_base);
     };
 
+    #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+    #endif
+
     template<typename Target, typename T>
     struct downcast_child : T
     {
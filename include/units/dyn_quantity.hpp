@@ -0,0 +1,336 @@
+#ifndef DYN_QUANTITY_HPP
+#define DYN_QUANTITY_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include "quantity.hpp"
+
+
+namespace units
+{
+    /**
+     * Slot of a base dimension in a dyn_dimension, from 0 to dyn_dimension::slot_count - 1.
+     * A base dimension opts in either by declaring a member
+     * `static constexpr unsigned dynamic_slot = ...;`
+     * or by specializing this trait with a `value` member.
+     * Two base dimensions used with dynamic quantities must not share the same slot.
+     */
+    template<typename Dimension, typename = void>
+    struct dynamic_slot {};
+
+    template<typename Dimension>
+    struct dynamic_slot<Dimension, std::void_t<decltype(Dimension::dynamic_slot)>>
+    {
+        static constexpr unsigned value = Dimension::dynamic_slot;
+    };
+
+    template<typename Dimension, typename = void>
+    struct has_dynamic_slot : std::false_type {};
+
+    template<typename Dimension>
+    struct has_dynamic_slot<Dimension, std::void_t<decltype(dynamic_slot<Dimension>::value)>> : std::true_type {};
+
+    template<typename Dimension>
+    inline constexpr bool has_dynamic_slot_v = has_dynamic_slot<Dimension>::value;
+
+    /**
+     * Dimension known at runtime, packed in a 64 bits word:
+     * the exponent of each base dimension is a signed 8 bits integer at its slot.
+     * Comparing is one integer compare, multiplying and dividing are additions and
+     * subtractions of every exponent at once. Exponents must stay within [-128, 127],
+     * which the operators assert and checked_multiply and checked_divide report.
+     */
+    class dyn_dimension
+    {
+    public:
+        static constexpr unsigned slot_count = 8;
+
+        constexpr dyn_dimension() = default;
+
+        static constexpr dyn_dimension from_packed(uint64_t packed) { return dyn_dimension(packed); }
+
+        constexpr uint64_t packed() const { return packed_; }
+
+        constexpr int exponent(unsigned slot) const
+        {
+            return int(int8_t(uint8_t(packed_ >> (8 * slot))));
+        }
+
+        constexpr dyn_dimension with_exponent(unsigned slot, int exponent) const
+        {
+            assert(slot < slot_count);
+            const uint64_t mask = uint64_t(0xff) << (8 * slot);
+            return dyn_dimension((packed_ & ~mask) | (uint64_t(uint8_t(exponent)) << (8 * slot)));
+        }
+
+        constexpr bool is_scalar() const { return packed_ == 0; }
+
+        friend constexpr bool operator==(dyn_dimension lhs, dyn_dimension rhs) { return lhs.packed_ == rhs.packed_; }
+
+        friend constexpr bool operator!=(dyn_dimension lhs, dyn_dimension rhs) { return lhs.packed_ != rhs.packed_; }
+
+        /**
+         * Product of the dimensions, or nothing if an exponent goes beyond [-128, 127]
+         */
+        friend constexpr std::optional<dyn_dimension> checked_multiply(dyn_dimension lhs, dyn_dimension rhs)
+        {
+            const uint64_t sum = add_lanes(lhs.packed_, rhs.packed_);
+            // a lane overflows if both exponents have the same sign and the sum another one
+            if(~(lhs.packed_ ^ rhs.packed_) & (lhs.packed_ ^ sum) & high_bits)
+                return std::nullopt;
+            return dyn_dimension(sum);
+        }
+
+        /**
+         * Quotient of the dimensions, or nothing if an exponent goes beyond [-128, 127]
+         */
+        friend constexpr std::optional<dyn_dimension> checked_divide(dyn_dimension lhs, dyn_dimension rhs)
+        {
+            const uint64_t difference = subtract_lanes(lhs.packed_, rhs.packed_);
+            // a lane overflows if the exponents have different signs and the difference the sign of rhs
+            if((lhs.packed_ ^ rhs.packed_) & (lhs.packed_ ^ difference) & high_bits)
+                return std::nullopt;
+            return dyn_dimension(difference);
+        }
+
+        friend constexpr dyn_dimension operator*(dyn_dimension lhs, dyn_dimension rhs)
+        {
+            assert(checked_multiply(lhs, rhs) && "Exponent out of range");
+            return dyn_dimension(add_lanes(lhs.packed_, rhs.packed_));
+        }
+
+        friend constexpr dyn_dimension operator/(dyn_dimension lhs, dyn_dimension rhs)
+        {
+            assert(checked_divide(lhs, rhs) && "Exponent out of range");
+            return dyn_dimension(subtract_lanes(lhs.packed_, rhs.packed_));
+        }
+
+    private:
+        static constexpr uint64_t high_bits = 0x8080808080808080u;
+        static constexpr uint64_t low_bits = ~high_bits;
+
+        constexpr explicit dyn_dimension(uint64_t packed) : packed_{packed} {}
+
+        static constexpr uint64_t add_lanes(uint64_t lhs, uint64_t rhs)
+        {
+            // add the lanes without their sign bit so that no carry crosses a lane,
+            // the sign bits are then the xor of the 3 sign bits
+            return ((lhs & low_bits) + (rhs & low_bits)) ^ ((lhs ^ rhs) & high_bits);
+        }
+
+        static constexpr uint64_t subtract_lanes(uint64_t lhs, uint64_t rhs)
+        {
+            // same with the sign bits set on the left so that no borrow crosses a lane
+            return ((lhs | high_bits) - (rhs & low_bits)) ^ ((lhs ^ ~rhs) & high_bits);
+        }
+
+        uint64_t packed_ = 0;
+    };
+
+    namespace detail
+    {
+        template<typename... DimensionPowers>
+        constexpr dyn_dimension make_dyn_dimension_impl(meta::typelist<DimensionPowers...>)
+        {
+            static_assert((has_dynamic_slot_v<typename DimensionPowers::Base> && ...),
+                          "Every base dimension used with dynamic quantities needs a dynamic slot");
+            static_assert(((dynamic_slot<typename DimensionPowers::Base>::value < dyn_dimension::slot_count) && ...),
+                          "Dynamic slot out of range");
+            static_assert(((DimensionPowers::exponent >= -128 && DimensionPowers::exponent <= 127) && ...),
+                          "Exponent too large for a dynamic dimension");
+            dyn_dimension dimension;
+            ((dimension = dimension.with_exponent(dynamic_slot<typename DimensionPowers::Base>::value,
+                                                  DimensionPowers::exponent)), ...);
+            return dimension;
+        }
+    }
+
+    /**
+     * dyn_dimension of a dimension, computed at compile time
+     */
+    template<typename Dimension>
+    inline constexpr dyn_dimension dyn_dimension_of = detail::make_dyn_dimension_impl(Dimension::typelist());
+
+    /**
+     * Quantity whose unit is only known at runtime: a value, the dimension and the scale of the unit,
+     * ie its value in the coherent unit of the dimension.
+     * Operations on quantities of different dimensions are checked with assertions by the operators,
+     * the checked_ functions and compare report them instead.
+     */
+    template<typename T = double>
+    class dyn_quantity
+    {
+    public:
+        using value_type = T;
+
+        constexpr dyn_quantity() = default;
+
+        constexpr dyn_quantity(T value, dyn_dimension dimension, double scale = 1.0) :
+            value_{std::move(value)}, dimension_{dimension}, scale_{scale}
+        {}
+
+        template<typename Unit, typename ApplyMagnitudePolicy>
+        constexpr dyn_quantity(const quantity<Unit, T, ApplyMagnitudePolicy>& q) :
+            value_{detail::quantity_maker::value(q)}, dimension_{dyn_dimension_of<typename Unit::Dimension>},
+            scale_{detail::magnitude_factor<typename Unit::Magnitude, double>}
+        {}
+
+        constexpr const T& value() const { return value_; }
+
+        constexpr dyn_dimension dimension() const { return dimension_; }
+
+        constexpr double scale() const { return scale_; }
+
+        /**
+         * Value in Unit, or nothing if Unit is not of the dimension of this quantity
+         */
+        template<typename Unit>
+        constexpr std::optional<T> in(Unit = {}) const
+        {
+            if(dimension_ != dyn_dimension_of<typename Unit::Dimension>)
+                return std::nullopt;
+            return rescaled(detail::magnitude_factor<typename Unit::Magnitude, double>);
+        }
+
+        /**
+         * Quantity of Unit, or nothing if Unit is not of the dimension of this quantity
+         */
+        template<typename Unit, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+        constexpr std::optional<quantity<Unit, T, ApplyMagnitudePolicy>> as(Unit = {}) const
+        {
+            if(dimension_ != dyn_dimension_of<typename Unit::Dimension>)
+                return std::nullopt;
+            return detail::quantity_maker::make<quantity<Unit, T, ApplyMagnitudePolicy>>(
+                rescaled(detail::magnitude_factor<typename Unit::Magnitude, double>));
+        }
+
+        friend constexpr bool same_dimension(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            return lhs.dimension_ == rhs.dimension_;
+        }
+
+        friend constexpr dyn_quantity operator+(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            assert(same_dimension(lhs, rhs));
+            return dyn_quantity(lhs.value_ + rhs.rescaled(lhs.scale_), lhs.dimension_, lhs.scale_);
+        }
+
+        friend constexpr dyn_quantity operator-(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            assert(same_dimension(lhs, rhs));
+            return dyn_quantity(lhs.value_ - rhs.rescaled(lhs.scale_), lhs.dimension_, lhs.scale_);
+        }
+
+        friend constexpr dyn_quantity operator*(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            return dyn_quantity(lhs.value_ * rhs.value_, lhs.dimension_ * rhs.dimension_, lhs.scale_ * rhs.scale_);
+        }
+
+        friend constexpr dyn_quantity operator/(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            return dyn_quantity(lhs.value_ / rhs.value_, lhs.dimension_ / rhs.dimension_, lhs.scale_ / rhs.scale_);
+        }
+
+        friend constexpr dyn_quantity operator*(const dyn_quantity& lhs, const T& rhs)
+        {
+            return dyn_quantity(lhs.value_ * rhs, lhs.dimension_, lhs.scale_);
+        }
+
+        friend constexpr dyn_quantity operator*(const T& lhs, const dyn_quantity& rhs) { return rhs * lhs; }
+
+        friend constexpr dyn_quantity operator/(const dyn_quantity& lhs, const T& rhs)
+        {
+            return dyn_quantity(lhs.value_ / rhs, lhs.dimension_, lhs.scale_);
+        }
+
+        friend constexpr bool operator==(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            assert(same_dimension(lhs, rhs));
+            return lhs.value_ == rhs.rescaled(lhs.scale_);
+        }
+
+        friend constexpr bool operator!=(const dyn_quantity& lhs, const dyn_quantity& rhs) { return !(lhs == rhs); }
+
+        friend constexpr bool operator<(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            assert(same_dimension(lhs, rhs));
+            return lhs.value_ < rhs.rescaled(lhs.scale_);
+        }
+
+        friend constexpr bool operator>(const dyn_quantity& lhs, const dyn_quantity& rhs) { return rhs < lhs; }
+
+        friend constexpr bool operator<=(const dyn_quantity& lhs, const dyn_quantity& rhs) { return !(rhs < lhs); }
+
+        friend constexpr bool operator>=(const dyn_quantity& lhs, const dyn_quantity& rhs) { return !(lhs < rhs); }
+
+        /**
+         * Sum in the scale of lhs, or nothing if the quantities have different dimensions
+         */
+        friend constexpr std::optional<dyn_quantity> checked_add(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            if(!same_dimension(lhs, rhs))
+                return std::nullopt;
+            return lhs + rhs;
+        }
+
+        /**
+         * Difference in the scale of lhs, or nothing if the quantities have different dimensions
+         */
+        friend constexpr std::optional<dyn_quantity> checked_subtract(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            if(!same_dimension(lhs, rhs))
+                return std::nullopt;
+            return lhs - rhs;
+        }
+
+        /**
+         * Product, or nothing if an exponent of its dimension goes beyond [-128, 127]
+         */
+        friend constexpr std::optional<dyn_quantity> checked_multiply(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            const auto dimension = checked_multiply(lhs.dimension_, rhs.dimension_);
+            if(!dimension)
+                return std::nullopt;
+            return dyn_quantity(lhs.value_ * rhs.value_, *dimension, lhs.scale_ * rhs.scale_);
+        }
+
+        /**
+         * Quotient, or nothing if an exponent of its dimension goes beyond [-128, 127]
+         */
+        friend constexpr std::optional<dyn_quantity> checked_divide(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            const auto dimension = checked_divide(lhs.dimension_, rhs.dimension_);
+            if(!dimension)
+                return std::nullopt;
+            return dyn_quantity(lhs.value_ / rhs.value_, *dimension, lhs.scale_ / rhs.scale_);
+        }
+
+        /**
+         * Negative if lhs < rhs, positive if lhs > rhs, 0 otherwise,
+         * or nothing if the quantities have different dimensions
+         */
+        friend constexpr std::optional<int> compare(const dyn_quantity& lhs, const dyn_quantity& rhs)
+        {
+            if(!same_dimension(lhs, rhs))
+                return std::nullopt;
+            return lhs < rhs ? -1 : rhs < lhs ? 1 : 0;
+        }
+
+    private:
+        // Value expressed with another scale of the same dimension
+        constexpr T rescaled(double scale) const
+        {
+            if(scale == scale_)
+                return value_;
+            return T(value_ * (scale_ / scale));
+        }
+
+        T value_{};
+        dyn_dimension dimension_;
+        double scale_ = 1.0;
+    };
+}
+
+#endif // DYN_QUANTITY_HPP
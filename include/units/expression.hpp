@@ -0,0 +1,218 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include "quantity.hpp"
+
+
+namespace units
+{
+    namespace detail
+    {
+        template<typename T>
+        inline constexpr bool is_expression_scalar =
+            !is_unit<T> && !is_quantity<T> && !is_quantity_expression<T>;
+
+        // Factors of the magnitude of the unit of UnitPower raised to its exponent
+        template<typename UnitPower>
+        constexpr auto unit_power_factors()
+        {
+            using UnitMagnitude = typename UnitPower::Base::Magnitude;
+            return meta::transform(magnitude_as_typelist<UnitMagnitude>(), [](auto powerType)
+            {
+                using FactorPower = typename decltype(powerType)::type;
+                return meta::type<Power<typename FactorPower::Base, FactorPower::exponent * UnitPower::exponent>>;
+            });
+        }
+
+        /**
+         * The factor lists of the units are merged as plain typelists,
+         * only the final magnitude_raw is instantiated
+         */
+        template<typename... UnitPowers>
+        constexpr auto expression_magnitude_impl()
+        {
+            auto list_of_factor_lists = meta::make_typelist(meta::type_of(unit_power_factors<UnitPowers>())...);
+            auto reducer = [](auto accumulated_list, auto list_to_add_type)
+            {
+                return meta::merge_combine_filter(accumulated_list, typename decltype(list_to_add_type)::type{},
+                                                  MagnitudeComparator{}, PowerCombiner{});
+            };
+            return meta::reduce(meta::make_typelist(), list_of_factor_lists, reducer)
+                .template as_type<magnitude_raw>();
+        }
+
+        template<typename... UnitPowers>
+        using expression_magnitude = typename decltype(expression_magnitude_impl<UnitPowers...>())::type;
+
+        template<typename T, typename ApplyMagnitudePolicy, typename... UnitPowers>
+        constexpr auto make_expression(meta::typelist<UnitPowers...>, T value)
+        {
+            return quantity_expression<T, ApplyMagnitudePolicy, UnitPowers...>(std::move(value));
+        }
+    }
+
+    /**
+     * Lazy product of quantities, units and scalars.
+     *
+     * The values are multiplied as the expression is built but its type only
+     * records the list of units involved (each as Power<Unit, 1> or Power<Unit, -1>),
+     * so no intermediate unit, dimension or magnitude is instantiated.
+     * The unit of the result and its magnitude are computed once, by merging the
+     * typelists of base dimensions and of factors of the units, and the magnitude is
+     * applied once when the expression is converted to a quantity or read with in().
+     *
+     * An expression is started from a quantity with `lazy`, for example
+     * `units::quantity<metre> distance = units::lazy(speed) * 10 * s;`
+     */
+    template<typename T, typename ApplyMagnitudePolicy, typename... UnitPowers>
+    class quantity_expression
+    {
+    public:
+        using value_type = T;
+        using units_list = meta::typelist<UnitPowers...>;
+        using dimension = meta::downcast<detail::make_combined_dimension_raw<
+            Power<typename UnitPowers::Base::Dimension, UnitPowers::exponent>...>>;
+        using magnitude = detail::expression_magnitude<UnitPowers...>;
+        using unit = meta::downcast<detail::unit_raw<dimension, magnitude>>;
+
+        constexpr explicit quantity_expression(T value) : value_{std::move(value)} {}
+
+        /**
+         * The value of the expression in the product of its units,
+         * ie before any magnitude is applied
+         */
+        constexpr const T& raw_value() const { return value_; }
+
+        template<typename Unit2, typename = std::enable_if_t<detail::is_unit<Unit2>>>
+        constexpr T in(Unit2 = {}) const
+        {
+            static_assert(std::is_same_v<dimension, typename Unit2::Dimension>,
+                          "The expression doesn't have the dimension of the unit");
+            using MagnitudeToApply = MultiplyMagnitude<magnitude, InverseMagnitude<typename Unit2::Magnitude>>;
+            return T(ApplyMagnitudePolicy::template apply<MagnitudeToApply>(value_));
+        }
+
+        /**
+         * Materialize the expression as a quantity of its combined unit
+         */
+        constexpr quantity<unit, T, ApplyMagnitudePolicy> eval() const
+        {
+            return detail::quantity_maker::make<quantity<unit, T, ApplyMagnitudePolicy>>(value_);
+        }
+
+        template<typename Unit2, typename T2>
+        constexpr operator quantity<Unit2, T2, ApplyMagnitudePolicy>() const
+        {
+            return detail::quantity_maker::make<quantity<Unit2, T2, ApplyMagnitudePolicy>>(T2(in<Unit2>()));
+        }
+
+    private:
+        T value_;
+    };
+
+    /**
+     * Start a lazy expression from a quantity
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+    constexpr auto lazy(const quantity<Unit, T, ApplyMagnitudePolicy>& value)
+    {
+        return quantity_expression<T, ApplyMagnitudePolicy, Power<Unit, 1>>(
+            detail::quantity_maker::value(value));
+    }
+
+    template<typename T1, typename T2, typename ApplyMagnitudePolicy, typename... UnitPowers1, typename... UnitPowers2>
+    constexpr auto operator*(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers1...>& lhs,
+                             const quantity_expression<T2, ApplyMagnitudePolicy, UnitPowers2...>& rhs)
+    {
+        return detail::make_expression<decltype(std::declval<T1>() * std::declval<T2>()), ApplyMagnitudePolicy>(
+            meta::typelist<UnitPowers1..., UnitPowers2...>{}, lhs.raw_value() * rhs.raw_value());
+    }
+
+    template<typename T1, typename T2, typename ApplyMagnitudePolicy, typename... UnitPowers1, typename... UnitPowers2>
+    constexpr auto operator/(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers1...>& lhs,
+                             const quantity_expression<T2, ApplyMagnitudePolicy, UnitPowers2...>& rhs)
+    {
+        return detail::make_expression<decltype(std::declval<T1>() / std::declval<T2>()), ApplyMagnitudePolicy>(
+            meta::typelist<UnitPowers1..., typename UnitPowers2::inverse...>{}, lhs.raw_value() / rhs.raw_value());
+    }
+
+    // Expression against quantity
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit, typename T2>
+    constexpr auto operator*(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& lhs,
+                             const quantity<Unit, T2, ApplyMagnitudePolicy>& rhs)
+    {
+        return lhs * lazy(rhs);
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit, typename T2>
+    constexpr auto operator*(const quantity<Unit, T2, ApplyMagnitudePolicy>& lhs,
+                             const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& rhs)
+    {
+        return lazy(lhs) * rhs;
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit, typename T2>
+    constexpr auto operator/(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& lhs,
+                             const quantity<Unit, T2, ApplyMagnitudePolicy>& rhs)
+    {
+        return lhs / lazy(rhs);
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit, typename T2>
+    constexpr auto operator/(const quantity<Unit, T2, ApplyMagnitudePolicy>& lhs,
+                             const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& rhs)
+    {
+        return lazy(lhs) / rhs;
+    }
+
+    // Expression against unit, only the unit list changes
+    template<typename T, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit,
+             typename = std::enable_if_t<detail::is_unit<Unit>>>
+    constexpr auto operator*(const quantity_expression<T, ApplyMagnitudePolicy, UnitPowers...>& lhs, Unit)
+    {
+        return quantity_expression<T, ApplyMagnitudePolicy, UnitPowers..., Power<Unit, 1>>(lhs.raw_value());
+    }
+
+    template<typename T, typename ApplyMagnitudePolicy, typename... UnitPowers, typename Unit,
+             typename = std::enable_if_t<detail::is_unit<Unit>>>
+    constexpr auto operator/(const quantity_expression<T, ApplyMagnitudePolicy, UnitPowers...>& lhs, Unit)
+    {
+        return quantity_expression<T, ApplyMagnitudePolicy, UnitPowers..., Power<Unit, -1>>(lhs.raw_value());
+    }
+
+    // Expression against scalar, only the value changes
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename T2,
+             typename = std::enable_if_t<detail::is_expression_scalar<T2>>>
+    constexpr auto operator*(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& lhs, const T2& rhs)
+    {
+        using ResT = decltype(std::declval<T1>() * std::declval<T2>());
+        return quantity_expression<ResT, ApplyMagnitudePolicy, UnitPowers...>(lhs.raw_value() * rhs);
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename T2,
+             typename = std::enable_if_t<detail::is_expression_scalar<T2>>>
+    constexpr auto operator*(const T2& lhs, const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& rhs)
+    {
+        using ResT = decltype(std::declval<T2>() * std::declval<T1>());
+        return quantity_expression<ResT, ApplyMagnitudePolicy, UnitPowers...>(lhs * rhs.raw_value());
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename T2,
+             typename = std::enable_if_t<detail::is_expression_scalar<T2>>>
+    constexpr auto operator/(const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& lhs, const T2& rhs)
+    {
+        using ResT = decltype(std::declval<T1>() / std::declval<T2>());
+        return quantity_expression<ResT, ApplyMagnitudePolicy, UnitPowers...>(lhs.raw_value() / rhs);
+    }
+
+    template<typename T1, typename ApplyMagnitudePolicy, typename... UnitPowers, typename T2,
+             typename = std::enable_if_t<detail::is_expression_scalar<T2>>>
+    constexpr auto operator/(const T2& lhs, const quantity_expression<T1, ApplyMagnitudePolicy, UnitPowers...>& rhs)
+    {
+        using ResT = decltype(std::declval<T2>() / std::declval<T1>());
+        return quantity_expression<ResT, ApplyMagnitudePolicy, typename UnitPowers::inverse...>(
+            lhs / rhs.raw_value());
+    }
+}
+
+#endif // EXPRESSION_HPP
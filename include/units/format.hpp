@@ -0,0 +1,118 @@
+#ifndef FORMAT_HPP
+#define FORMAT_HPP
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include "quantity.hpp"
+#include "symbol.hpp"
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+
+namespace units
+{
+    namespace detail
+    {
+        // Longest text written by std::to_chars for a T in its shortest form
+        template<typename T>
+        constexpr size_t max_chars()
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be formatted");
+            if constexpr(std::is_floating_point_v<T>)
+                // sign, point, exponent sign and up to 5 exponent digits
+                return size_t(std::numeric_limits<T>::max_digits10) + 9;
+            else
+                return size_t(std::numeric_limits<T>::digits10) + 2;
+        }
+    }
+
+    /**
+     * Most characters written by format_to for a Quantity
+     */
+    template<typename Quantity>
+    inline constexpr size_t max_formatted_size =
+        detail::max_chars<typename Quantity::value_type>() + 1 + unit_symbol_of<typename Quantity::unit>.size();
+
+    /**
+     * Write a quantity as its value, in the shortest form of std::to_chars, followed by the
+     * symbol of its unit, eg "12.5 km". The quantity is written as is, without conversion.
+     * Like std::to_chars, nothing is written past last and nothing is allocated.
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+    std::to_chars_result to_chars(char* first, char* last, const quantity<Unit, T, ApplyMagnitudePolicy>& q)
+    {
+        auto result = std::to_chars(first, last, detail::quantity_maker::value(q));
+        constexpr std::string_view symbol = unit_symbol_of<Unit>;
+        if(result.ec != std::errc{} || symbol.empty())
+            return result;
+        if(size_t(last - result.ptr) < symbol.size() + 1)
+            return {last, std::errc::value_too_large};
+        *result.ptr++ = ' ';
+        std::memcpy(result.ptr, symbol.data(), symbol.size());
+        result.ptr += symbol.size();
+        return result;
+    }
+
+    /**
+     * Same as to_chars for a buffer of at least max_formatted_size characters,
+     * returns the end of the text
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+    char* format_to(char* out, const quantity<Unit, T, ApplyMagnitudePolicy>& q)
+    {
+        return to_chars(out, out + max_formatted_size<quantity<Unit, T, ApplyMagnitudePolicy>>, q).ptr;
+    }
+}
+
+/**
+ * Formatters for std::format, and fmt if it is included before this header.
+ * The format specification applies to the value, the symbol of the unit is appended,
+ * eg `std::format("{:.2f}", 12.345 * km)` gives "12.35 km".
+ */
+#if defined(__cpp_lib_format)
+template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+struct std::formatter<units::quantity<Unit, T, ApplyMagnitudePolicy>, char> : std::formatter<T, char>
+{
+    template<typename FormatContext>
+    auto format(const units::quantity<Unit, T, ApplyMagnitudePolicy>& q, FormatContext& context) const
+    {
+        auto out = std::formatter<T, char>::format(units::detail::quantity_maker::value(q), context);
+        constexpr std::string_view symbol = units::unit_symbol_of<Unit>;
+        if constexpr(!symbol.empty())
+        {
+            *out++ = ' ';
+            out = std::copy(symbol.begin(), symbol.end(), out);
+        }
+        return out;
+    }
+};
+#endif
+
+#if defined(FMT_VERSION)
+template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+struct fmt::formatter<units::quantity<Unit, T, ApplyMagnitudePolicy>, char> : fmt::formatter<T, char>
+{
+    template<typename FormatContext>
+    auto format(const units::quantity<Unit, T, ApplyMagnitudePolicy>& q, FormatContext& context) const
+    {
+        auto out = fmt::formatter<T, char>::format(units::detail::quantity_maker::value(q), context);
+        constexpr std::string_view symbol = units::unit_symbol_of<Unit>;
+        if constexpr(!symbol.empty())
+        {
+            *out++ = ' ';
+            out = std::copy(symbol.begin(), symbol.end(), out);
+        }
+        return out;
+    }
+};
+#endif
+
+#endif // FORMAT_HPP
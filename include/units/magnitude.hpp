@@ -2,9 +2,10 @@
 #define MAGNITUDE_HPP
 
 #include <cstdint>
+#include <string_view>
 #include "power.hpp"
+#include "ordinal.hpp"
 #include "primes.hpp"
-#include "type_name.hpp"
 
 
 namespace units
@@ -17,6 +18,9 @@ namespace units
 
     struct pi
     {
+        static constexpr uint64_t ordinal = 1;
+        static constexpr std::string_view symbol = "\u03c0";
+
         template<typename T>
         static constexpr T value()
         {
@@ -82,44 +86,42 @@ namespace units
 
         struct MagnitudeComparator
         {
-            template<typename PowFactorType1, typename PowFactorType2>
-            constexpr auto
-            operator()(const PowFactorType1&,
-                       const PowFactorType2&) const
+            // Compare int factor by value
+            // Compare other factors by ordinal, or by type name if they don't have one
+            // Other factor are always after int factor
+            struct key_type
             {
-                using PowFactor1 = typename PowFactorType1::type;
-                using PowFactor2 = typename PowFactorType2::type;
-                using Factor1 = typename PowFactor1::Base;
-                using Factor2 = typename PowFactor2::Base;
-                // Compare int factor by value
-                // Compare other factors by type name
-                // Other factor are always after int factor
-                if constexpr(is_int_factor<Factor1> && is_int_factor<Factor2>)
+                bool is_int = true;
+                uint64_t value = 0;
+                meta::type_key irrational;
+
+                constexpr bool operator<(const key_type& other) const
                 {
-                    constexpr auto val1 = Factor1::value;
-                    constexpr auto val2 = Factor2::value;
-                    if constexpr(val1 == val2)
-                        return meta::val<meta::ordering::equivalent>;
-                    else if constexpr(val1 < val2)
-                        return meta::val<meta::ordering::less>;
+                    if(is_int != other.is_int)
+                        return is_int;
+                    else if(is_int)
+                        return value < other.value;
                     else
-                        return meta::val<meta::ordering::greater>;
+                        return irrational < other.irrational;
                 }
-                else if constexpr(is_int_factor<Factor1>)
-                    return meta::val<meta::ordering::less>;
-                else if constexpr(is_int_factor<Factor2>)
-                    return meta::val<meta::ordering::greater>;
+            };
+
+            template<typename PowFactorType>
+            static constexpr key_type key(const PowFactorType&)
+            {
+                using Factor = typename PowFactorType::type::Base;
+                if constexpr(is_int_factor<Factor>)
+                    return {true, static_cast<uint64_t>(Factor::value), {}};
                 else
-                {
-                    constexpr auto factor1Name = meta::type_name<Factor1>();
-                    constexpr auto factor2Name = meta::type_name<Factor2>();
-                    if constexpr(factor1Name == factor2Name)
-                        return meta::val<meta::ordering::equivalent>;
-                    else if constexpr(factor1Name < factor2Name)
-                        return meta::val<meta::ordering::less>;
-                    else
-                        return meta::val<meta::ordering::greater>;
-                }
+                    return {false, 0, meta::make_type_key<Factor>()};
+            }
+
+            template<typename PowFactorType1, typename PowFactorType2>
+            constexpr auto
+            operator()(const PowFactorType1&,
+                       const PowFactorType2&) const
+            {
+                return meta::val<meta::compare_keys(key(PowFactorType1{}), key(PowFactorType2{}))>;
             }
         };
 
@@ -148,6 +150,68 @@ namespace units
             return inverse_list.template as_type<magnitude_raw>();
         }
 
+        /**
+         * A magnitude as a fraction num / den of 64 bits integers
+         * The fraction is always reduced because every prime factor
+         * appears either in the numerator or in the denominator.
+         * is_rational is false if the magnitude has an irrational factor and
+         * fits is false if the numerator or the denominator doesn't fit in 64 bits.
+         */
+        struct magnitude_ratio_t
+        {
+            uint64_t num = 1;
+            uint64_t den = 1;
+            bool is_rational = true;
+            bool fits = true;
+
+            constexpr void multiply(uint64_t& part, uint64_t factor, int exponent)
+            {
+                for(int i = 0; i < exponent; ++i)
+                {
+                    if(part > UINT64_MAX / factor)
+                        fits = false;
+                    part *= factor;
+                }
+            }
+        };
+
+        template<typename FactorPower>
+        constexpr void add_to_ratio(magnitude_ratio_t& ratio)
+        {
+            using Factor = typename FactorPower::Base;
+            constexpr int exp = FactorPower::exponent;
+            if constexpr(!is_int_factor<Factor>)
+                ratio.is_rational = false;
+            else if constexpr(exp > 0)
+                ratio.multiply(ratio.num, Factor::value, exp);
+            else
+                ratio.multiply(ratio.den, Factor::value, -exp);
+        }
+
+        template<typename... FactorPowers>
+        constexpr magnitude_ratio_t magnitude_ratio_impl(const magnitude_raw<FactorPowers...>&)
+        {
+            magnitude_ratio_t ratio;
+            (add_to_ratio<FactorPowers>(ratio), ...);
+            return ratio;
+        }
+
+        template<typename Magnitude>
+        inline constexpr magnitude_ratio_t magnitude_ratio = magnitude_ratio_impl(Magnitude{});
+
+        /**
+         * Detect magnitudes that are a power of two (other than 2^0)
+         * exponent is then the power of two
+         */
+        template<typename Magnitude>
+        struct power_of_two_magnitude : std::false_type {};
+
+        template<int Exponent>
+        struct power_of_two_magnitude<magnitude_raw<Power<int_factor<2>, Exponent>>> : std::true_type
+        {
+            static constexpr int exponent = Exponent;
+        };
+
         template<typename Magnitude1, typename Magnitude2>
         constexpr auto multiply_magnitude_impl()
         {
@@ -1,6 +1,8 @@
 #ifndef META_HPP
 #define META_HPP
 
+#include <array>
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 #include <compare>
@@ -18,6 +20,20 @@ namespace meta
         return static_cast<int>(ord) <= 0;
     }
 
+    /**
+     * Compare two ordering keys, which only need to be comparable with `<`
+     */
+    template<typename Key>
+    constexpr ordering compare_keys(const Key& key1, const Key& key2)
+    {
+        if(key1 < key2)
+            return ordering::less;
+        else if(key2 < key1)
+            return ordering::greater;
+        else
+            return ordering::equivalent;
+    }
+
     template<auto v>
     struct ValueConstant
     {
@@ -90,8 +106,6 @@ namespace meta
     inline constexpr NoTypeConstant notype;
 
 
-    #define meta_if(...) if constexpr(decltype(__VA_ARGS__)::value)
-
     template<typename... Ts>
     struct typelist
     {
@@ -163,48 +177,318 @@ namespace meta
         return typelist<Ts1..., Ts2...>{};
     }
 
-    template<typename Idx, typename LeftList, typename RightList>
-    constexpr auto split_impl(const Idx& idx, const LeftList& left, const RightList& right)
+    namespace detail
     {
-        meta_if(idx > val<0>)
+        template<size_t I, typename T>
+        struct indexed_type
         {
-            // move elements from right to left
-            auto newOutput1 = left.append(right.head());
-            return split_impl(idx - val<1>, newOutput1, right.tail());
-        }
-        else
-            return std::make_pair(left, right);
+            using type = T;
+        };
+
+        template<typename IndexSequence, typename... Ts>
+        struct indexed_types;
+
+        template<size_t... Is, typename... Ts>
+        struct indexed_types<std::index_sequence<Is...>, Ts...> : indexed_type<Is, Ts>... {};
+
+        template<size_t I, typename T>
+        indexed_type<I, T> select_indexed(const indexed_type<I, T>&);
+
+        template<size_t I, typename... Ts>
+        using type_at = typename decltype(select_indexed<I>(
+            std::declval<const indexed_types<std::index_sequence_for<Ts...>, Ts...>&>()))::type;
     }
 
-    template<typename Idx, typename List>
-    constexpr auto split(const Idx& idx, const List& list)
+    /**
+     * Access the type at the given index of a typelist.
+     * The lookup is done by overload resolution against a flat set of base
+     * classes so it doesn't recurse over the list.
+     */
+    template<size_t I, typename... Ts>
+    constexpr auto at(const typelist<Ts...>&)
     {
-        return split_impl(idx, typelist<>{}, list);
+        static_assert(I < sizeof...(Ts), "Index out of bounds");
+        return type<detail::type_at<I, Ts...>>;
     }
 
-    template<typename ResultList, typename SortedList1, typename SortedList2, typename Comparator>
-    constexpr auto
-    merge_impl(const ResultList& result, const SortedList1& list1,
-               const SortedList2& list2, const Comparator& Comp)
+    namespace detail
     {
-        meta_if(list1.empty())return concat(result, list2);
-        else meta_if(list2.empty())return concat(result, list1);
-        else
+        template<size_t Offset, typename... Ts, size_t... Is>
+        constexpr auto slice_impl(const typelist<Ts...>&, std::index_sequence<Is...>)
+        {
+            return typelist<type_at<Offset + Is, Ts...>...>{};
+        }
+
+        template<size_t Offset, size_t Count, typename List>
+        constexpr auto slice(const List& list)
         {
-            constexpr auto compare_result = val<decltype(Comp(list1.head(), list2.head()))::value>;
-            if constexpr(is_less_or_equivalent(compare_result))
+            return slice_impl<Offset>(list, std::make_index_sequence<Count>{});
+        }
+
+        template<typename Comparator, typename = void>
+        struct has_ordering_key : std::false_type {};
+
+        template<typename Comparator>
+        struct has_ordering_key<Comparator, std::void_t<typename Comparator::key_type>> :
+            std::true_type {};
+
+        /**
+         * Comparisons between any element of List1 and any element of List2, by index.
+         * If the comparator exposes an ordering key (a key_type and a static key function),
+         * only one key per element is computed and the comparisons are done by
+         * constexpr evaluation on the keys.
+         * Otherwise the comparator is invoked on every pair of elements: the table costs
+         * sizeof...(Ts1) * sizeof...(Ts2) instantiations, so without keys merges stay
+         * quadratic in the number of types, only their recursion depth is gone.
+         */
+        template<typename Comparator, typename List1, typename List2,
+                 bool = has_ordering_key<Comparator>::value>
+        struct list_comparisons;
+
+        template<typename Comparator, typename... Ts1, typename... Ts2>
+        struct list_comparisons<Comparator, typelist<Ts1...>, typelist<Ts2...>, true>
+        {
+            using key_type = typename Comparator::key_type;
+
+            static constexpr std::array<key_type, sizeof...(Ts1)> keys1 =
+                {{Comparator::key(type<Ts1>)...}};
+            static constexpr std::array<key_type, sizeof...(Ts2)> keys2 =
+                {{Comparator::key(type<Ts2>)...}};
+
+            static constexpr ordering compare(size_t i, size_t j)
             {
-                auto newResult = result.append(list1.head());
-                auto newList1 = list1.tail();
-                return merge_impl(newResult, newList1, list2, Comp);
+                return compare_keys(keys1[i], keys2[j]);
             }
-            else
+        };
+
+        template<typename Comparator, typename... Ts1, typename... Ts2>
+        struct list_comparisons<Comparator, typelist<Ts1...>, typelist<Ts2...>, false>
+        {
+            template<typename T1>
+            static constexpr std::array<ordering, sizeof...(Ts2)> row()
             {
-                auto newResult = result.append(list2.head());
-                auto newList2 = list2.tail();
-                return merge_impl(newResult, list1, newList2, Comp);
+                return {{decltype(
+                    std::declval<const Comparator&>()(type<T1>, type<Ts2>))::value...}};
             }
+
+            static constexpr std::array<std::array<ordering, sizeof...(Ts2)>, sizeof...(Ts1)> table =
+                {{row<Ts1>()...}};
+
+            static constexpr ordering compare(size_t i, size_t j) { return table[i][j]; }
+        };
+
+        enum struct merge_source : int
+        {
+            first, second, both
+        };
+
+        struct merge_step
+        {
+            merge_source source = merge_source::first;
+            size_t index1 = 0;
+            size_t index2 = 0;
+        };
+
+        template<size_t N1, size_t N2>
+        struct merge_plan
+        {
+            std::array<merge_step, N1 + N2> steps{};
+            size_t size = 0;
+
+            constexpr void add(merge_source source, size_t index1, size_t index2)
+            {
+                steps[size] = {source, index1, index2};
+                ++size;
+            }
+        };
+
+        /**
+         * Run the classic merge of two sorted sequences on indices only.
+         * When combine_equivalent is set, equivalent elements produce a single
+         * step that refers to both of them.
+         */
+        template<typename Comparisons, size_t N1, size_t N2>
+        constexpr merge_plan<N1, N2> make_merge_plan(bool combine_equivalent)
+        {
+            merge_plan<N1, N2> plan;
+            size_t i = 0;
+            size_t j = 0;
+            while(i < N1 && j < N2)
+            {
+                const ordering ord = Comparisons::compare(i, j);
+                if(combine_equivalent && ord == ordering::equivalent)
+                {
+                    plan.add(merge_source::both, i, j);
+                    ++i;
+                    ++j;
+                }
+                else if(is_less_or_equivalent(ord))
+                {
+                    plan.add(merge_source::first, i, 0);
+                    ++i;
+                }
+                else
+                {
+                    plan.add(merge_source::second, 0, j);
+                    ++j;
+                }
+            }
+            for(; i < N1; ++i)
+                plan.add(merge_source::first, i, 0);
+            for(; j < N2; ++j)
+                plan.add(merge_source::second, 0, j);
+            return plan;
         }
+
+        template<size_t N>
+        struct index_selection
+        {
+            std::array<size_t, N> indices{};
+            size_t size = 0;
+        };
+
+        /**
+         * Merge two sorted typelists without recursing over them.
+         * The merge itself is done on indices by a constexpr function and
+         * the resulting typelist is built by a single pack expansion.
+         * If Combine is void, equivalent elements are all kept, otherwise they
+         * are replaced by the result of Combine, which can filter them out by
+         * returning notype.
+         */
+        template<typename List1, typename List2, typename Comparator, typename Combine>
+        struct merge_lists;
+
+        template<typename... Ts1, typename... Ts2, typename Comparator, typename Combine>
+        struct merge_lists<typelist<Ts1...>, typelist<Ts2...>, Comparator, Combine>
+        {
+            using comparisons = list_comparisons<Comparator, typelist<Ts1...>, typelist<Ts2...>>;
+
+            static constexpr auto plan =
+                make_merge_plan<comparisons, sizeof...(Ts1), sizeof...(Ts2)>(!std::is_void_v<Combine>);
+
+            template<size_t Step>
+            static constexpr auto step_type()
+            {
+                constexpr merge_step step = plan.steps[Step];
+                if constexpr(step.source == merge_source::first)
+                    return meta::type<type_at<step.index1, Ts1...>>;
+                else if constexpr(step.source == merge_source::second)
+                    return meta::type<type_at<step.index2, Ts2...>>;
+                else
+                    return decltype(std::declval<const Combine&>()(
+                        meta::type<type_at<step.index1, Ts1...>>,
+                        meta::type<type_at<step.index2, Ts2...>>)){};
+            }
+
+            template<size_t... Steps>
+            static constexpr auto select_kept_steps(std::index_sequence<Steps...>)
+            {
+                constexpr bool kept[] = {
+                    !std::is_same_v<decltype(step_type<Steps>()), NoTypeConstant>..., false};
+                index_selection<sizeof...(Steps)> selection;
+                for(size_t step = 0; step < sizeof...(Steps); ++step)
+                {
+                    if(kept[step])
+                    {
+                        selection.indices[selection.size] = step;
+                        ++selection.size;
+                    }
+                }
+                return selection;
+            }
+
+            static constexpr auto kept_steps =
+                select_kept_steps(std::make_index_sequence<plan.size>{});
+
+            template<size_t... Is>
+            static constexpr auto make(std::index_sequence<Is...>)
+            {
+                return typelist<typename decltype(step_type<kept_steps.indices[Is]>())::type...>{};
+            }
+
+            using type = decltype(make(std::make_index_sequence<kept_steps.size>{}));
+        };
+
+        /**
+         * Stable sort of a typelist without recursing over it.
+         * The final position of each element is its rank, ie the number of
+         * elements that must come before it.
+         * Computing the ranks takes O(n^2) constexpr comparisons, and as many comparator
+         * instantiations when the comparator has no ordering key.
+         */
+        template<typename Comparator, typename... Ts>
+        struct sort_list
+        {
+            using comparisons = list_comparisons<Comparator, typelist<Ts...>, typelist<Ts...>>;
+
+            static constexpr size_t size = sizeof...(Ts);
+
+            static constexpr std::array<size_t, size> make_permutation()
+            {
+                std::array<size_t, size> permutation{};
+                for(size_t i = 0; i < size; ++i)
+                {
+                    size_t rank = 0;
+                    for(size_t j = 0; j < size; ++j)
+                    {
+                        const ordering ord = comparisons::compare(j, i);
+                        if(ord == ordering::less || (ord == ordering::equivalent && j < i))
+                            ++rank;
+                    }
+                    permutation[rank] = i;
+                }
+                return permutation;
+            }
+
+            static constexpr std::array<size_t, size> permutation = make_permutation();
+
+            template<size_t... Is>
+            static constexpr auto make(std::index_sequence<Is...>)
+            {
+                return typelist<type_at<permutation[Is], Ts...>...>{};
+            }
+
+            using type = decltype(make(std::index_sequence_for<Ts...>{}));
+        };
+
+        template<typename Result, typename Reducer>
+        struct reduce_accumulator
+        {
+            Result result;
+            Reducer reducer;
+
+            template<typename T>
+            friend constexpr auto operator<<(const reduce_accumulator& acc, const TypeConstant<T>& t)
+            {
+                using NewResult = decltype(acc.reducer(acc.result, t));
+                return reduce_accumulator<NewResult, Reducer>{acc.reducer(acc.result, t), acc.reducer};
+            }
+        };
+    }
+
+    template<typename Idx, typename... Ts>
+    constexpr auto split(const Idx&, const typelist<Ts...>& list)
+    {
+        constexpr size_t idx = Idx::value;
+        static_assert(idx <= sizeof...(Ts), "Cannot split past the end of the list");
+        return std::make_pair(detail::slice<0, idx>(list),
+                              detail::slice<idx, sizeof...(Ts) - idx>(list));
+    }
+
+    template<typename Idx, typename LeftList, typename RightList>
+    constexpr auto split_impl(const Idx& idx, const LeftList& left, const RightList& right)
+    {
+        // move idx elements from right to left
+        auto[moved, rest] = split(idx, right);
+        return std::make_pair(concat(left, moved), rest);
+    }
+
+    template<typename ResultList, typename SortedList1, typename SortedList2, typename Comparator>
+    constexpr auto
+    merge_impl(const ResultList& result, const SortedList1&, const SortedList2&, const Comparator&)
+    {
+        using Merged = typename detail::merge_lists<SortedList1, SortedList2, Comparator, void>::type;
+        return concat(result, Merged{});
     }
 
     template<typename SortedList1, typename SortedList2, typename Comparator>
@@ -214,15 +498,9 @@ namespace meta
     }
 
     template<typename... Ts, typename Comparator>
-    constexpr auto sort(const typelist<Ts...>& list, const Comparator& Comp)
+    constexpr auto sort(const typelist<Ts...>&, const Comparator&)
     {
-        meta_if(list.size() < val<2>)return list;
-
-        auto half_size = list.size() / val<2>;
-        auto[left, right] = split(half_size, list);
-        auto sorted_left = sort(left, Comp);
-        auto sorted_right = sort(right, Comp);
-        return merge(sorted_left, sorted_right, Comp);
+        return typename detail::sort_list<Comparator, Ts...>::type{};
     }
 
 
@@ -234,47 +512,12 @@ namespace meta
 
     template<typename ResultList, typename SortedList1, typename SortedList2, typename Comparator, typename Combine>
     constexpr auto
-    merge_combine_filter_impl(const ResultList& result, const SortedList1& list1, const SortedList2& list2,
-                              const Comparator& Comp, const Combine& combine)
+    merge_combine_filter_impl(const ResultList& result, const SortedList1&, const SortedList2&,
+                              const Comparator&, const Combine&)
     {
-        meta_if(list1.empty())return concat(result, list2);
-        else meta_if(list2.empty())return concat(result, list1);
-        else
-        {
-            constexpr auto compare_result = val<decltype(Comp(list1.head(), list2.head()))::value>;
-            if constexpr(compare_result == ordering::equivalent)
-            {
-                // Need to combine
-                auto newList1 = list1.tail();
-                auto newList2 = list2.tail();
-                auto combine_result = combine(list1.head(), list2.head());
-                meta_if(combine_result == type_of(notype))
-                {
-                    // filtered out, add nothing to result
-                    return merge_combine_filter_impl(result, newList1, newList2, Comp, combine);
-                }
-                else
-                {
-                    // Add the reduced thing to result 
-                    auto newResult = result.append(combine_result);
-                    return merge_combine_filter_impl(newResult, newList1, newList2, Comp, combine);
-                }
-            }
-            else if constexpr(compare_result == ordering::less)
-            {
-                // Move from list 1 to result
-                auto newResult = result.append(list1.head());
-                auto newList1 = list1.tail();
-                return merge_combine_filter_impl(newResult, newList1, list2, Comp, combine);
-            }
-            else
-            {
-                // Move from list 2 to result
-                auto newResult = result.append(list2.head());
-                auto newList2 = list2.tail();
-                return merge_combine_filter_impl(newResult, list1, newList2, Comp, combine);
-            }
-        }
+        using Merged =
+            typename detail::merge_lists<SortedList1, SortedList2, Comparator, Combine>::type;
+        return concat(result, Merged{});
     }
 
     template<typename SortedList1, typename SortedList2, typename Comparator, typename Combine>
@@ -284,15 +527,15 @@ namespace meta
         return merge_combine_filter_impl(typelist<>{}, list1, list2, Comp, combine);
     }
 
-    template<typename Result, typename InputList, typename Reducer>
-    constexpr auto reduce(const Result& result, const InputList& list, const Reducer& reducer)
+    /**
+     * Left fold of the reducer over the types of the list, starting from result.
+     * This is a fold expression so it doesn't recurse over the list.
+     */
+    template<typename Result, typename... Ts, typename Reducer>
+    constexpr auto reduce(const Result& result, const typelist<Ts...>&, const Reducer& reducer)
     {
-        meta_if(list.empty())return result;
-        else
-            return reduce(reducer(result, list.head()), list.tail(), reducer);
+        return (detail::reduce_accumulator<Result, Reducer>{result, reducer} << ... << type<Ts>).result;
     }
-
-    #undef meta_if
 }
 
 #endif // META_HPP
\ No newline at end of file
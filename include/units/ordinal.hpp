@@ -0,0 +1,111 @@
+#ifndef ORDINAL_HPP
+#define ORDINAL_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "type_name.hpp"
+
+
+namespace meta
+{
+    /**
+     * Explicit ordering key of a type, used to sort types in a canonical order
+     * that doesn't depend on the compiler.
+     *
+     * A type opts in either by declaring a member
+     * `static constexpr uint64_t ordinal = ...;`
+     * or by specializing this trait with a `value` member, which is useful for types
+     * that cannot be modified.
+     * Two different types that are compared with each other must not share the same ordinal.
+     */
+    template<typename T, typename = void>
+    struct ordinal {};
+
+    template<typename T>
+    struct ordinal<T, std::void_t<decltype(T::ordinal)>>
+    {
+        static constexpr uint64_t value = T::ordinal;
+    };
+
+    template<typename T, typename = void>
+    struct has_ordinal : std::false_type {};
+
+    template<typename T>
+    struct has_ordinal<T, std::void_t<decltype(ordinal<T>::value)>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool has_ordinal_v = has_ordinal<T>::value;
+
+    /**
+     * Ordering key of a type.
+     * Types with an ordinal come first and are sorted by their ordinal,
+     * the other types come after and are sorted by their type name.
+     * The type name is only computed for types without an ordinal.
+     */
+    struct type_key
+    {
+        bool has_ordinal = false;
+        uint64_t ordinal = 0;
+        std::string_view name;
+
+        constexpr bool operator<(const type_key& other) const
+        {
+            if(has_ordinal != other.has_ordinal)
+                return has_ordinal;
+            else if(has_ordinal)
+                return ordinal < other.ordinal;
+            else
+                return name < other.name;
+        }
+    };
+
+    template<typename T>
+    constexpr type_key make_type_key()
+    {
+        if constexpr(has_ordinal_v<T>)
+            return {true, ordinal<T>::value, {}};
+        else
+            return {false, 0, type_name<T>()};
+    }
+
+    // FNV-1a
+    constexpr uint64_t hash_name(std::string_view name)
+    {
+        uint64_t hash = 0xcbf29ce484222325u;
+        for(char c : name)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3u;
+        }
+        return hash;
+    }
+
+    /**
+     * Identifier of a type that can be stored or compared at runtime:
+     * its ordinal, or a hash of its type name for types without one.
+     */
+    struct type_id
+    {
+        bool has_ordinal = false;
+        uint64_t value = 0;
+
+        constexpr bool operator==(const type_id& other) const
+        {
+            return has_ordinal == other.has_ordinal && value == other.value;
+        }
+
+        constexpr bool operator!=(const type_id& other) const { return !(*this == other); }
+    };
+
+    template<typename T>
+    constexpr type_id make_type_id()
+    {
+        if constexpr(has_ordinal_v<T>)
+            return {true, ordinal<T>::value};
+        else
+            return {false, hash_name(type_name<T>())};
+    }
+}
+
+#endif // ORDINAL_HPP
@@ -0,0 +1,405 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "quantity.hpp"
+
+// Not included by units.hpp: the thread pool needs to link with the threads library,
+// eg Threads::Threads in CMake
+// The standard execution policies are accepted when UNITS_STD_EXECUTION is defined,
+// they may need to link with a parallel backend, eg TBB for libstdc++
+#if defined(UNITS_STD_EXECUTION)
+#include <execution>
+#endif
+
+
+namespace units
+{
+    /**
+     * Fixed set of threads running a number of tasks, the calling thread takes part.
+     * The tasks are split evenly between the workers, and a worker that runs out of
+     * tasks steals half of the remaining tasks of another one.
+     * One run happens at a time, concurrent calls to run wait for each other.
+     */
+    class thread_pool
+    {
+    public:
+        explicit thread_pool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) :
+            slots_(std::max<size_t>(threads, 1))
+        {
+            for(size_t i = 1; i < slots_.size(); ++i)
+                threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for(auto& thread : threads_)
+                thread.join();
+        }
+
+        /**
+         * Number of workers, including the calling thread
+         */
+        size_t size() const { return slots_.size(); }
+
+        /**
+         * Call fn(task, worker) for every task in [0, tasks), on at most max_workers workers
+         * (all of them when it is 0). worker is in [0, size()) and no two tasks run at the
+         * same time on the same worker.
+         */
+        template<typename Fn>
+        void run(size_t tasks, size_t max_workers, Fn&& fn)
+        {
+            size_t workers = std::min(max_workers == 0 ? size() : std::min(max_workers, size()), tasks);
+            if(workers <= 1)
+            {
+                for(size_t task = 0; task < tasks; ++task)
+                    fn(task, size_t(0));
+                return;
+            }
+            assert(tasks <= UINT32_MAX);
+
+            std::lock_guard run_lock(run_mutex_);
+            for(size_t worker = 0; worker < slots_.size(); ++worker)
+            {
+                const uint64_t begin = worker < workers ? tasks * worker / workers : 0;
+                const uint64_t end = worker < workers ? tasks * (worker + 1) / workers : 0;
+                slots_[worker].range.store(pack(begin, end), std::memory_order_relaxed);
+            }
+            {
+                std::lock_guard lock(mutex_);
+                context_ = &fn;
+                invoke_ = [](void* context, size_t task, size_t worker)
+                {
+                    (*static_cast<std::remove_reference_t<Fn>*>(context))(task, worker);
+                };
+                workers_ = workers;
+                finished_ = 0;
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            work(0);
+
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&] { return finished_ == workers - 1; });
+        }
+
+    private:
+        struct alignas(64) slot
+        {
+            // [begin, end) of the tasks left to this worker, packed to be updated at once
+            std::atomic<uint64_t> range{0};
+        };
+
+        static constexpr uint64_t pack(uint64_t begin, uint64_t end) { return begin << 32u | end; }
+
+        static constexpr uint64_t begin_of(uint64_t range) { return range >> 32u; }
+
+        static constexpr uint64_t end_of(uint64_t range) { return range & UINT32_MAX; }
+
+        bool pop(size_t worker, size_t& task)
+        {
+            uint64_t range = slots_[worker].range.load(std::memory_order_relaxed);
+            while(begin_of(range) < end_of(range))
+            {
+                if(slots_[worker].range.compare_exchange_weak(range, pack(begin_of(range) + 1, end_of(range)),
+                                                              std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    task = size_t(begin_of(range));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool steal(size_t worker)
+        {
+            for(size_t i = 1; i < slots_.size(); ++i)
+            {
+                auto& victim = slots_[(worker + i) % slots_.size()].range;
+                uint64_t range = victim.load(std::memory_order_relaxed);
+                while(begin_of(range) < end_of(range))
+                {
+                    const uint64_t middle = begin_of(range) + (end_of(range) - begin_of(range)) / 2;
+                    if(victim.compare_exchange_weak(range, pack(begin_of(range), middle),
+                                                    std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        slots_[worker].range.store(pack(middle, end_of(range)), std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void work(size_t worker)
+        {
+            size_t task;
+            do
+            {
+                while(pop(worker, task))
+                    invoke_(context_, task, worker);
+            } while(steal(worker));
+        }
+
+        void worker_loop(size_t worker)
+        {
+            uint64_t seen = 0;
+            for(;;)
+            {
+                {
+                    std::unique_lock lock(mutex_);
+                    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                    if(stop_)
+                        return;
+                    seen = generation_;
+                    if(worker >= workers_)
+                        continue;
+                }
+                work(worker);
+                {
+                    std::lock_guard lock(mutex_);
+                    ++finished_;
+                }
+                done_.notify_one();
+            }
+        }
+
+        std::vector<slot> slots_;
+        std::vector<std::thread> threads_;
+
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        bool stop_ = false;
+        uint64_t generation_ = 0;
+        size_t workers_ = 0;
+        size_t finished_ = 0;
+        void* context_ = nullptr;
+        void (*invoke_)(void*, size_t, size_t) = nullptr;
+    };
+
+    /**
+     * Pool used by the parallel algorithms by default, with a thread per core
+     */
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    namespace execution
+    {
+        struct sequenced_policy {};
+
+        struct parallel_policy
+        {
+            // default_thread_pool() if null
+            thread_pool* pool = nullptr;
+            // all the threads of the pool if 0
+            size_t max_threads = 0;
+            // give bitwise identical results whatever the number of threads
+            bool deterministic = false;
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+        inline constexpr parallel_policy par_deterministic{nullptr, 0, true};
+    }
+
+    namespace detail
+    {
+        template<typename Policy>
+        inline constexpr bool is_units_execution_policy =
+            std::is_same_v<Policy, execution::sequenced_policy> || std::is_same_v<Policy, execution::parallel_policy>;
+
+        template<typename Policy>
+        constexpr bool is_std_execution_policy()
+        {
+        #if defined(UNITS_STD_EXECUTION)
+            return std::is_execution_policy_v<Policy>;
+        #else
+            return false;
+        #endif
+        }
+
+        template<typename Policy>
+        inline constexpr bool is_execution_policy =
+            is_units_execution_policy<std::decay_t<Policy>> || is_std_execution_policy<std::decay_t<Policy>>();
+
+        /**
+         * The values are reduced by chunks of this size, in a fixed order inside a chunk.
+         * The chunks don't depend on the number of threads so that combining them in order
+         * gives the same result with any number of threads.
+         */
+        inline constexpr size_t reduce_chunk_size = 16384;
+
+        // Sum of f(i) for i in [begin, end), with independent accumulators so that
+        // the additions don't wait for each other
+        template<typename Acc, typename F>
+        Acc sum_range(size_t begin, size_t end, F&& f)
+        {
+            Acc acc[4] = {};
+            size_t i = begin;
+            for(; i + 4 <= end; i += 4)
+            {
+                acc[0] += f(i);
+                acc[1] += f(i + 1);
+                acc[2] += f(i + 2);
+                acc[3] += f(i + 3);
+            }
+            for(; i < end; ++i)
+                acc[0] += f(i);
+            return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        }
+
+        template<typename Acc, typename F>
+        Acc chunked_sum(const execution::sequenced_policy&, size_t n, F&& f)
+        {
+            Acc total{};
+            for(size_t begin = 0; begin < n; begin += reduce_chunk_size)
+                total += sum_range<Acc>(begin, std::min(n, begin + reduce_chunk_size), f);
+            return total;
+        }
+
+        template<typename Acc, typename F>
+        Acc chunked_sum(const execution::parallel_policy& policy, size_t n, F&& f)
+        {
+            thread_pool& pool = policy.pool ? *policy.pool : default_thread_pool();
+            const size_t chunks = (n + reduce_chunk_size - 1) / reduce_chunk_size;
+            auto chunk_sum = [&](size_t chunk)
+            {
+                const size_t begin = chunk * reduce_chunk_size;
+                return sum_range<Acc>(begin, std::min(n, begin + reduce_chunk_size), f);
+            };
+
+            Acc total{};
+            if(policy.deterministic)
+            {
+                std::vector<Acc> partials(chunks);
+                pool.run(chunks, policy.max_threads, [&](size_t chunk, size_t) { partials[chunk] = chunk_sum(chunk); });
+                for(const Acc& partial : partials)
+                    total += partial;
+            }
+            else
+            {
+                struct alignas(64) partial
+                {
+                    Acc value{};
+                };
+                std::vector<partial> partials(pool.size());
+                pool.run(chunks, policy.max_threads,
+                         [&](size_t chunk, size_t worker) { partials[worker].value += chunk_sum(chunk); });
+                for(const auto& p : partials)
+                    total += p.value;
+            }
+            return total;
+        }
+
+    #if defined(UNITS_STD_EXECUTION)
+        template<typename Acc, typename Policy, typename F, typename = std::enable_if_t<std::is_execution_policy_v<Policy>>>
+        Acc chunked_sum(const Policy& policy, size_t n, F&& f)
+        {
+            const size_t chunks = (n + reduce_chunk_size - 1) / reduce_chunk_size;
+            std::vector<size_t> indices(chunks);
+            std::iota(indices.begin(), indices.end(), size_t(0));
+            return std::transform_reduce(policy, indices.begin(), indices.end(), Acc{}, std::plus<>(),
+                                         [&](size_t chunk)
+                                         {
+                                             const size_t begin = chunk * reduce_chunk_size;
+                                             return sum_range<Acc>(begin, std::min(n, begin + reduce_chunk_size), f);
+                                         });
+        }
+    #endif
+
+        template<typename Range>
+        using range_quantity = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(std::declval<Range&>()))>>;
+    }
+
+    /**
+     * Sum of a contiguous range of quantities (std::vector, quantity_vector, std::array, ...).
+     * policy is units::execution::seq, units::execution::par (or a parallel_policy with a pool,
+     * a number of threads or the deterministic mode) or a standard execution policy (see UNITS_STD_EXECUTION).
+     * With seq or a deterministic parallel_policy, the result doesn't depend on the number of threads.
+     */
+    template<typename Policy, typename Range, typename = std::enable_if_t<detail::is_execution_policy<Policy>>>
+    auto reduce(const Policy& policy, const Range& range)
+    {
+        using Quantity = detail::range_quantity<Range>;
+        using T = typename Quantity::value_type;
+        static_assert(detail::is_layout_compatible_quantity<Quantity>);
+        const T* values = reinterpret_cast<const T*>(std::data(range));
+        return detail::quantity_maker::make<Quantity>(
+            detail::chunked_sum<T>(policy, std::size(range), [values](size_t i) { return values[i]; }));
+    }
+
+    template<typename Policy, typename Range, typename Quantity,
+             typename = std::enable_if_t<detail::is_execution_policy<Policy>>>
+    Quantity reduce(const Policy& policy, const Range& range, const Quantity& init)
+    {
+        return init + reduce(policy, range);
+    }
+
+    /**
+     * Sum of transform(q) for every quantity q of a contiguous range, transform returns a quantity
+     */
+    template<typename Policy, typename Range, typename Transform,
+             typename = std::enable_if_t<detail::is_execution_policy<Policy>>>
+    auto transform_reduce(const Policy& policy, const Range& range, Transform transform)
+    {
+        using Result = std::decay_t<decltype(transform(*std::data(range)))>;
+        static_assert(detail::is_quantity<Result>, "The transformation must give a quantity");
+        using T = typename Result::value_type;
+        const auto* quantities = std::data(range);
+        return detail::quantity_maker::make<Result>(detail::chunked_sum<T>(
+            policy, std::size(range),
+            [&](size_t i) { return detail::quantity_maker::value(transform(quantities[i])); }));
+    }
+
+    /**
+     * Sum of the products of the quantities of 2 contiguous ranges, like convert only
+     * the pairs present in both ranges are used when their sizes differ.
+     * The unit of the result is the product of the units, eg an energy for forces and distances.
+     */
+    template<typename Policy, typename Range1, typename Range2,
+             typename = std::enable_if_t<detail::is_execution_policy<Policy>>>
+    auto inner_product(const Policy& policy, const Range1& lhs, const Range2& rhs)
+    {
+        using Quantity1 = detail::range_quantity<Range1>;
+        using Quantity2 = detail::range_quantity<Range2>;
+        using Result = decltype(std::declval<Quantity1>() * std::declval<Quantity2>());
+        using T1 = typename Quantity1::value_type;
+        using T2 = typename Quantity2::value_type;
+        static_assert(detail::is_layout_compatible_quantity<Quantity1> &&
+                      detail::is_layout_compatible_quantity<Quantity2>);
+        const size_t n = std::min<size_t>(std::size(lhs), std::size(rhs));
+        const T1* lhs_values = reinterpret_cast<const T1*>(std::data(lhs));
+        const T2* rhs_values = reinterpret_cast<const T2*>(std::data(rhs));
+        return detail::quantity_maker::make<Result>(detail::chunked_sum<typename Result::value_type>(
+            policy, n, [=](size_t i) { return lhs_values[i] * rhs_values[i]; }));
+    }
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,343 @@
+#ifndef PARSE_HPP
+#define PARSE_HPP
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include "quantity.hpp"
+#include "span.hpp"
+#include "symbol.hpp"
+
+
+namespace units
+{
+    namespace detail
+    {
+        inline constexpr size_t parsed_unit_capacity = 8;
+        // largest power a unit or a base dimension can be raised to in a text
+        inline constexpr int parsed_exponent_limit = 127;
+
+        constexpr bool is_parsed_exponent(int exponent)
+        {
+            return exponent >= -parsed_exponent_limit && exponent <= parsed_exponent_limit;
+        }
+
+        /**
+         * base raised to exponent by squaring
+         */
+        constexpr long double power(long double base, int exponent)
+        {
+            long double result = 1;
+            unsigned int n = exponent < 0 ? 0u - unsigned(exponent) : unsigned(exponent);
+            for(; n != 0; n /= 2, base *= base)
+                if(n % 2 != 0)
+                    result *= base;
+            return exponent < 0 ? 1 / result : result;
+        }
+
+        /**
+         * A unit known at runtime: base dimensions raised to some power
+         * and the value of its magnitude
+         */
+        struct parsed_unit
+        {
+            struct term
+            {
+                meta::type_id dimension;
+                int exponent;
+            };
+
+            long double factor = 1;
+            size_t size = 0;
+            term terms[parsed_unit_capacity] = {};
+
+            /**
+             * Multiply by other raised to exponent, false if the exponent or the resulting
+             * power of a dimension is beyond parsed_exponent_limit or there are too many dimensions
+             */
+            constexpr bool multiply(const parsed_unit& other, int exponent)
+            {
+                if(!is_parsed_exponent(exponent))
+                    return false;
+                factor *= power(other.factor, exponent);
+
+                for(size_t i = 0; i < other.size; ++i)
+                {
+                    size_t j = 0;
+                    while(j < size && terms[j].dimension != other.terms[i].dimension)
+                        ++j;
+                    if(j == size)
+                    {
+                        if(size == parsed_unit_capacity)
+                            return false;
+                        terms[size++] = {other.terms[i].dimension, 0};
+                    }
+                    // both exponents are within the limit so this doesn't overflow
+                    terms[j].exponent += other.terms[i].exponent * exponent;
+                    if(!is_parsed_exponent(terms[j].exponent))
+                        return false;
+                    if(terms[j].exponent == 0)
+                        terms[j] = terms[--size];
+                }
+                return true;
+            }
+
+            constexpr bool same_dimension(const parsed_unit& other) const
+            {
+                if(size != other.size)
+                    return false;
+                for(size_t i = 0; i < size; ++i)
+                {
+                    size_t j = 0;
+                    while(j < size && other.terms[j].dimension != terms[i].dimension)
+                        ++j;
+                    if(j == size || other.terms[j].exponent != terms[i].exponent)
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        template<typename... DimensionPowers>
+        constexpr parsed_unit make_parsed_unit_impl(meta::typelist<DimensionPowers...>, long double factor)
+        {
+            static_assert(sizeof...(DimensionPowers) <= parsed_unit_capacity, "Unit too complex to be parsed");
+            parsed_unit unit;
+            unit.factor = factor;
+            unit.size = sizeof...(DimensionPowers);
+            size_t i = 0;
+            ((unit.terms[i++] = {meta::make_type_id<typename DimensionPowers::Base>(), DimensionPowers::exponent}), ...);
+            return unit;
+        }
+
+        template<typename Unit>
+        inline constexpr parsed_unit parsed_unit_of = make_parsed_unit_impl(
+            Unit::Dimension::typelist(), magnitude_value<typename Unit::Magnitude, long double>());
+
+        struct symbol_entry
+        {
+            std::string_view symbol;
+            parsed_unit unit;
+        };
+
+        constexpr bool is_unit_separator(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '*' || c == '/' || c == '^';
+        }
+    }
+
+    /**
+     * The units that can be read from text, each one must have a symbol (see unit_symbol).
+     * `using telemetry_units = units::symbol_table<metre, kilometre, second, hour>;`
+     * The table is built at compile time.
+     */
+    template<typename... Units>
+    struct symbol_table
+    {
+        static_assert(sizeof...(Units) > 0, "A symbol table needs at least one unit");
+        static_assert((has_unit_symbol_v<Units> && ...), "Every unit of a symbol table needs a symbol");
+
+        static constexpr detail::symbol_entry entries[] = {
+            {unit_symbol<Units>::value, detail::parsed_unit_of<Units>}...};
+
+        static constexpr const detail::parsed_unit* find(std::string_view symbol)
+        {
+            for(const auto& entry : entries)
+                if(entry.symbol == symbol)
+                    return &entry.unit;
+            return nullptr;
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * Parse quantities of Unit written as a number followed by a product of unit symbols
+         * of Symbols, like "12.5 km/s" or "3 kg*m/s^2". The factor of the last unit read is
+         * kept, so that a run of values with the same unit only pays the lookup once.
+         */
+        template<typename Unit, typename T, typename Symbols>
+        class quantity_parser
+        {
+        public:
+            bool parse(const char*& first, const char* last, T& out)
+            {
+                const char* it = first;
+                while(it != last && (*it == ' ' || *it == '\t'))
+                    ++it;
+                T value{};
+                const auto [number_end, error] = std::from_chars(it, last, value);
+                if(error != std::errc{})
+                    return false;
+                it = number_end;
+                while(it != last && (*it == ' ' || *it == '\t'))
+                    ++it;
+
+                // the unit text goes until the end of the buffer or of the line
+                const char* unit_end = static_cast<const char*>(std::memchr(it, '\n', size_t(last - it)));
+                unit_end = unit_end ? unit_end : last;
+                while(unit_end != it && (unit_end[-1] == ' ' || unit_end[-1] == '\t' || unit_end[-1] == '\r'))
+                    --unit_end;
+                const std::string_view unit_text(it, size_t(unit_end - it));
+
+                if(!has_cached_ || unit_text != cached_text_)
+                {
+                    if(!read_factor(unit_text))
+                        return false;
+                    cached_text_ = unit_text;
+                    has_cached_ = true;
+                }
+
+                if(is_identity_)
+                    out = value;
+                else
+                    out = T(factor_ * value);
+                first = unit_end;
+                return true;
+            }
+
+        private:
+            using Factor = decltype(std::declval<T>() * std::declval<double>());
+
+            bool read_factor(std::string_view text)
+            {
+                parsed_unit unit;
+                int sign = 1;
+                size_t i = 0;
+                while(i < text.size())
+                {
+                    const size_t symbol_begin = i;
+                    while(i < text.size() && !is_unit_separator(text[i]))
+                        ++i;
+                    const parsed_unit* symbol = Symbols::find(text.substr(symbol_begin, i - symbol_begin));
+                    if(!symbol)
+                        return false;
+
+                    int exponent = 1;
+                    if(i < text.size() && text[i] == '^')
+                    {
+                        const auto [exponent_end, error] = std::from_chars(text.data() + i + 1,
+                                                                           text.data() + text.size(), exponent);
+                        if(error != std::errc{} || exponent == 0 || !is_parsed_exponent(exponent))
+                            return false;
+                        i = size_t(exponent_end - text.data());
+                    }
+                    if(!unit.multiply(*symbol, sign * exponent))
+                        return false;
+
+                    while(i < text.size() && (text[i] == ' ' || text[i] == '\t'))
+                        ++i;
+                    if(i == text.size())
+                        break;
+                    if(text[i] != '*' && text[i] != '/')
+                        return false;
+                    sign = text[i] == '/' ? -1 : 1;
+                    ++i;
+                    while(i < text.size() && (text[i] == ' ' || text[i] == '\t'))
+                        ++i;
+                    if(i == text.size())
+                        return false;
+                }
+
+                constexpr parsed_unit target = parsed_unit_of<Unit>;
+                if(!unit.same_dimension(target))
+                    return false;
+                const long double factor = unit.factor / target.factor;
+                // a factor that overflows or underflows would make every value infinite or zero
+                if(!std::isfinite(Factor(factor)) || Factor(factor) == 0)
+                    return false;
+                is_identity_ = factor == 1;
+                factor_ = Factor(factor);
+                return true;
+            }
+
+            std::string_view cached_text_;
+            bool has_cached_ = false;
+            bool is_identity_ = true;
+            Factor factor_ = 1;
+        };
+    }
+
+    /**
+     * Read a quantity of Unit from a text like "12.5 km/s".
+     * The number is read with std::from_chars, it is followed by units of the symbol table
+     * joined by '*' and '/', and raised to a power with '^' between -127 and 127. They must have
+     * the dimension of Unit and the value is converted to Unit. Nothing is allocated.
+     */
+    template<typename Unit, typename T = double, typename... KnownUnits>
+    std::optional<quantity<Unit, T>> parse(std::string_view text, symbol_table<KnownUnits...> = {})
+    {
+        static_assert(sizeof...(KnownUnits) > 0, "The units to read must be given in a symbol table");
+        detail::quantity_parser<Unit, T, symbol_table<KnownUnits...>> parser;
+        const char* first = text.data();
+        const char* last = first + text.size();
+        T value{};
+        if(!parser.parse(first, last, value))
+            return std::nullopt;
+        while(first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+            ++first;
+        if(first != last)
+            return std::nullopt;
+        return detail::quantity_maker::make<quantity<Unit, T>>(value);
+    }
+
+    struct parse_lines_result
+    {
+        // number of quantities written
+        size_t count = 0;
+        // number of characters read, the lines after it are left unread
+        size_t consumed = 0;
+        // false if the reading stopped on a line that is not a quantity
+        bool ok = true;
+    };
+
+    /**
+     * Read one quantity of Unit per line from a buffer, see parse.
+     * Empty lines are skipped. The reading stops when out is full or on the first
+     * line that cannot be read, and can be resumed after the consumed characters.
+     */
+    template<typename Unit, typename T = double, typename... KnownUnits>
+    parse_lines_result parse_lines(std::string_view lines, span<quantity<Unit, T>> out,
+                                   symbol_table<KnownUnits...> = {})
+    {
+        static_assert(sizeof...(KnownUnits) > 0, "The units to read must be given in a symbol table");
+        detail::quantity_parser<Unit, T, symbol_table<KnownUnits...>> parser;
+        T* values = reinterpret_cast<T*>(out.data());
+        const char* first = lines.data();
+        const char* last = first + lines.size();
+        parse_lines_result result;
+
+        while(first != last && result.count < out.size())
+        {
+            const char* line = first;
+            while(line != last && (*line == ' ' || *line == '\t' || *line == '\r'))
+                ++line;
+            if(line != last && *line == '\n')
+            {
+                first = line + 1;
+                continue;
+            }
+            if(line == last)
+            {
+                first = last;
+                break;
+            }
+            const char* it = line;
+            if(!parser.parse(it, last, values[result.count]))
+            {
+                result.ok = false;
+                break;
+            }
+            ++result.count;
+            const char* newline = static_cast<const char*>(std::memchr(it, '\n', size_t(last - it)));
+            first = newline ? newline + 1 : last;
+        }
+        result.consumed = size_t(first - lines.data());
+        return result;
+    }
+}
+
+#endif // PARSE_HPP
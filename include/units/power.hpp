@@ -36,7 +36,9 @@ namespace units
                 using Pow1 = typename Pow1Type::type;
                 using Pow2 = typename Pow2Type::type;
                 using Base = typename Pow1::Base;
-                static_assert(meta::type<Base> == meta::type<typename Pow2::Base>);
+                static_assert(meta::type<Base> == meta::type<typename Pow2::Base>,
+                              "Two different types are ordered as equivalent, "
+                              "are they sharing the same ordinal?");
                 constexpr auto exp1 = Pow1::exponent;
                 constexpr auto exp2 = Pow2::exponent;
                 if constexpr (exp1 + exp2 == 0)
@@ -15,13 +15,13 @@ namespace units
             uint64_t factor;
             int exponent;
         };
-        // 14 is enough for the prime factorization of every integer smaller than 2^64
-        // because the smaller integer with 15 factors in its prime factorization
-        // is the product fo the 15 first prime numbers
+        // 15 is enough for the prime factorization of every integer smaller than 2^64
+        // because the smaller integer with 16 factors in its prime factorization
+        // is the product fo the 16 first prime numbers
         // (2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23 * 29 * 31 * 37 * 41 * 43 * 47 * 53)
         // which is 32 589 158 477 190 044 730 and is greater than 
         // 2^64 = 18 446 744 073 709 551 616
-        std::array<factor_exponent, 14> factors{};
+        std::array<factor_exponent, 15> factors{};
         size_t size = 0;
 
         constexpr void add_factor(uint64_t factor, int exponent)
@@ -31,62 +31,275 @@ namespace units
         }
     };
 
-    constexpr prime_factorization_result_t prime_factorization(uint64_t n)
+    namespace detail
     {
-        prime_factorization_result_t result;
-        const uint64_t originalN = n;
+        #ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 uint128_t;
+        __extension__ typedef __int128 int128_t;
+        #endif
 
-        // n must be divisible by factor for calling this function
-        auto process_factor = [&](uint64_t factor)
+        struct wide_product
         {
-            // check to what power n is divisible by factor and add to the prime factorization
-            int exponent = 0;
-            do
-            {
-                n /= factor;
-                ++exponent;
-            } while(n % factor == 0);
-            result.add_factor(factor, exponent);
+            uint64_t high;
+            uint64_t low;
         };
 
+        /**
+         * Full 128 bits product of 2 64 bits integers
+         */
+        constexpr wide_product multiply_wide(uint64_t a, uint64_t b)
+        {
+            #ifdef __SIZEOF_INT128__
+            const uint128_t product = static_cast<uint128_t>(a) * b;
+            return {static_cast<uint64_t>(product >> 64u), static_cast<uint64_t>(product)};
+            #else
+            // schoolbook multiplication on 32 bits halves
+            // note: this is about twice as costly for constant evaluation, factoring the
+            // hardest 64 bits semiprimes can then require a higher constexpr operation limit
+            const uint64_t a_low = a & 0xFFFFFFFFu;
+            const uint64_t a_high = a >> 32u;
+            const uint64_t b_low = b & 0xFFFFFFFFu;
+            const uint64_t b_high = b >> 32u;
+            const uint64_t low_low = a_low * b_low;
+            const uint64_t high_low = a_high * b_low;
+            const uint64_t low_high = a_low * b_high;
+            const uint64_t high_high = a_high * b_high;
+            const uint64_t middle = (low_low >> 32u) + (high_low & 0xFFFFFFFFu) + low_high;
+            return {high_high + (high_low >> 32u) + (middle >> 32u),
+                    (middle << 32u) | (low_low & 0xFFFFFFFFu)};
+            #endif
+        }
+
+        /**
+         * Arithmetic modulo an odd n in Montgomery form (with R = 2^64)
+         * so that no 128 bits division is ever needed
+         */
+        struct montgomery
+        {
+            uint64_t n;
+            uint64_t n_inverse; // n * n_inverse = 1 mod 2^64
+            uint64_t r2;        // R^2 mod n
+            uint64_t one;       // R mod n, ie 1 in Montgomery form
+
+            explicit constexpr montgomery(uint64_t modulus) :
+                n(modulus), n_inverse(modulus), r2(0), one((0 - modulus) % modulus)
+            {
+                // Newton iteration, each step doubles the number of correct bits
+                for(int i = 0; i < 5; ++i)
+                    n_inverse *= 2 - n * n_inverse;
+                r2 = one;
+                for(int i = 0; i < 64; ++i)
+                    r2 = add(r2, r2);
+            }
 
-        if(n % 2 == 0)
-            process_factor(2);
-        if(n % 3 == 0)
-            process_factor(3);
+            constexpr uint64_t add(uint64_t a, uint64_t b) const
+            {
+                return a >= n - b ? a - (n - b) : a + b;
+            }
 
-        uint64_t factor = 1;
-        uint64_t incr = 4;
+            constexpr uint64_t reduce(wide_product t) const
+            {
+                const uint64_t m = t.low * n_inverse;
+                const uint64_t mn_high = multiply_wide(m, n).high;
+                return t.high >= mn_high ? t.high - mn_high : t.high + (n - mn_high);
+            }
 
-        auto advance_to_next_prime = [&]
+            constexpr uint64_t multiply(uint64_t a, uint64_t b) const
+            {
+                return reduce(multiply_wide(a, b));
+            }
+
+            constexpr uint64_t to_montgomery(uint64_t a) const
+            {
+                return multiply(a % n, r2);
+            }
+
+            constexpr uint64_t power(uint64_t base, uint64_t exp) const
+            {
+                uint64_t result = one;
+                while(exp > 0)
+                {
+                    if(exp & 1u)
+                        result = multiply(result, base);
+                    base = multiply(base, base);
+                    exp >>= 1u;
+                }
+                return result;
+            }
+        };
+
+        constexpr uint64_t gcd(uint64_t a, uint64_t b)
         {
-            // Advance to next prime that divides n
-            // note: no need to check that factor is prime,
-            // if it divides n, it must be prime because every composite number
-            // smaller than factor are product of primes number that already been
-            // handled
-            do
+            while(b != 0)
             {
-                factor += incr;
-                incr ^= 6ULL; // toggle between 2 and 4 to have a 6-wheel
-            } while(n % factor != 0 && factor * factor < originalN);
+                const uint64_t r = a % b;
+                a = b;
+                b = r;
+            }
+            return a;
+        }
+
+        // Primes handled by trial division before using Miller-Rabin and Pollard rho.
+        // Every prime factor of the SI prefix ratios is in there so they are factored
+        // with only a few divisions.
+        inline constexpr std::array<uint64_t, 25> small_primes = {
+            2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47,
+            53, 59, 61, 67, 71, 73, 79, 83, 89, 97
         };
 
-        advance_to_next_prime();
+        /**
+         * Deterministic Miller-Rabin primality test
+         * The witnesses used are enough for every integer smaller than 2^64
+         */
+        constexpr bool is_prime(uint64_t n)
+        {
+            if(n < 2)
+                return false;
+            for(uint64_t p : small_primes)
+            {
+                if(n % p == 0)
+                    return n == p;
+            }
 
-        while(n > 1 && factor * factor < originalN)
+            uint64_t d = n - 1;
+            int s = 0;
+            while(d % 2 == 0)
+            {
+                d /= 2;
+                ++s;
+            }
+
+            const montgomery mont(n);
+            const uint64_t minus_one = n - mont.one;
+            constexpr uint64_t witnesses[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+            for(uint64_t a : witnesses)
+            {
+                uint64_t x = mont.power(mont.to_montgomery(a), d);
+                if(x == mont.one || x == minus_one)
+                    continue;
+                bool composite = true;
+                for(int r = 1; r < s; ++r)
+                {
+                    x = mont.multiply(x, x);
+                    if(x == minus_one)
+                    {
+                        composite = false;
+                        break;
+                    }
+                }
+                if(composite)
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * Find a non trivial divisor of n with Pollard rho (Brent variant)
+         * n must be composite and odd
+         */
+        constexpr uint64_t pollard_rho(uint64_t n)
         {
-            process_factor(factor);
-            advance_to_next_prime();
+            // gcd are computed on the product of a batch of differences
+            constexpr uint64_t batch_size = 128;
+            // Everything is done in Montgomery form, it doesn't change the gcd
+            // because R is coprime with n
+            const montgomery mont(n);
+
+            for(uint64_t c = 1;; ++c)
+            {
+                auto f = [&](uint64_t x) { return mont.add(mont.multiply(x, x), c); };
+
+                uint64_t y = 2;
+                uint64_t x = 2;
+                uint64_t ys = 2;
+                uint64_t q = mont.one;
+                uint64_t g = 1;
+                for(uint64_t r = 1; g == 1; r *= 2)
+                {
+                    x = y;
+                    for(uint64_t i = 0; i < r; ++i)
+                        y = f(y);
+                    for(uint64_t k = 0; k < r && g == 1; k += batch_size)
+                    {
+                        ys = y;
+                        for(uint64_t i = 0; i < batch_size && i < r - k; ++i)
+                        {
+                            y = f(y);
+                            q = mont.multiply(q, x > y ? x - y : y - x);
+                        }
+                        g = gcd(q, n);
+                    }
+                }
+
+                if(g == n)
+                {
+                    // The batch went too far, redo it one step at a time
+                    do
+                    {
+                        ys = f(ys);
+                        g = gcd(x > ys ? x - ys : ys - x, n);
+                    } while(g == 1);
+                }
+
+                if(g != n)
+                    return g;
+                // Failure, try again with another polynomial
+            }
         }
+    }
 
-        if(n > 1)
+    constexpr prime_factorization_result_t prime_factorization(uint64_t n)
+    {
+        prime_factorization_result_t result;
+
+        // Strip the small prime factors by trial division
+        for(uint64_t p : detail::small_primes)
         {
-            // If n has not been reduced to 1, it means n is greater than
-            // sqrt(originalN) and it divides originalN so it must be prime
-            result.add_factor(n, 1);
+            if(n % p == 0)
+            {
+                int exponent = 0;
+                do
+                {
+                    n /= p;
+                    ++exponent;
+                } while(n % p == 0);
+                result.add_factor(p, exponent);
+            }
         }
 
+        // Split what remains into primes, every prime found is greater than the small primes
+        // so they are inserted in order after them
+        const size_t first_big_factor = result.size;
+        std::array<uint64_t, 64> to_split{};
+        size_t to_split_size = 0;
+        if(n > 1)
+            to_split[to_split_size++] = n;
+
+        while(to_split_size > 0)
+        {
+            const uint64_t m = to_split[--to_split_size];
+            if(detail::is_prime(m))
+            {
+                size_t i = first_big_factor;
+                while(i < result.size && result.factors[i].factor < m)
+                    ++i;
+                if(i < result.size && result.factors[i].factor == m)
+                    ++result.factors[i].exponent;
+                else
+                {
+                    for(size_t j = result.size; j > i; --j)
+                        result.factors[j] = result.factors[j - 1];
+                    result.factors[i] = {m, 1};
+                    ++result.size;
+                }
+            }
+            else
+            {
+                const uint64_t divisor = detail::pollard_rho(m);
+                to_split[to_split_size++] = divisor;
+                to_split[to_split_size++] = m / divisor;
+            }
+        }
 
         return result;
     }
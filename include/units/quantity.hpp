@@ -1,6 +1,7 @@
 #ifndef QUANTITY_HPP
 #define QUANTITY_HPP
 
+#include <limits>
 #include "unit.hpp"
 
 
@@ -11,6 +12,12 @@ namespace units
     template<typename Unit, typename T = double, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
     class quantity;
 
+    template<typename T, typename ApplyMagnitudePolicy, typename... UnitPowers>
+    class quantity_expression;
+
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy, typename PendingMagnitude>
+    class quantity_conversion;
+
     namespace detail
     {
         struct quantity_maker;
@@ -22,6 +29,14 @@ namespace units
         template<typename T>
         inline constexpr bool is_quantity = decltype(is_quantity_impl(std::declval<T>()))::value; 
 
+        std::false_type is_quantity_expression_impl(...);
+        template<typename T, typename Policy, typename... UnitPowers>
+        std::true_type is_quantity_expression_impl(const quantity_expression<T, Policy, UnitPowers...>&);
+
+        template<typename T>
+        inline constexpr bool is_quantity_expression =
+            decltype(is_quantity_expression_impl(std::declval<T>()))::value;
+
         template<typename Unit, typename T, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
         class quantity_base
         {
@@ -43,6 +58,14 @@ namespace units
                 std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension> && detail::is_unit<Unit2>>>
             constexpr T in(Unit2 = {}) const;
 
+            /**
+             * Convert to Unit2 without applying any factor yet,
+             * see quantity_conversion
+             */
+            template<typename Unit2, typename = std::enable_if_t<
+                std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension> && detail::is_unit<Unit2>>>
+            constexpr auto as_lazy(Unit2 = {}) const;
+
             constexpr Quantity operator+() const { return Quantity(+value_); }
 
             constexpr Quantity operator-() const { return Quantity(-value_); }
@@ -101,14 +124,22 @@ namespace units
                 return value_ >= other.value_;
             }
             
-            template<typename OtherT, typename = std::enable_if_t<std::is_convertible_v<T, OtherT>>>
-            operator quantity<Unit, OtherT, ApplyMagnitudePolicy>() const;
+            template<typename OtherT, typename OtherPolicy,
+                     typename = std::enable_if_t<std::is_convertible_v<T, OtherT>>>
+            operator quantity<Unit, OtherT, OtherPolicy>() const;
 
         protected:
             template<typename Unit2, typename T2, typename ApplyMagnitudePolicy2>
             friend class quantity_base;
 
-            constexpr explicit quantity_base(T value) : value_{std::move(value)} {}
+            constexpr explicit quantity_base(T value) : value_{std::move(value)}
+            {
+                // A quantity is nothing more than its value, so that buffers of T
+                // can be viewed as quantities and copied as raw memory
+                static_assert(sizeof(Quantity) == sizeof(T) && alignof(Quantity) == alignof(T));
+                static_assert(std::is_standard_layout_v<Quantity> || !std::is_standard_layout_v<T>);
+                static_assert(std::is_trivially_copyable_v<Quantity> || !std::is_trivially_copyable_v<T>);
+            }
 
             T value_;
         };
@@ -153,12 +184,22 @@ namespace units
 
     namespace detail
     {
+        /**
+         * Whether a buffer of Quantity::value_type can be viewed as a buffer of Quantity,
+         * this is always true for arithmetic types
+         */
+        template<typename Quantity>
+        inline constexpr bool is_layout_compatible_quantity =
+            std::is_standard_layout_v<Quantity> &&
+            sizeof(Quantity) == sizeof(typename Quantity::value_type) &&
+            alignof(Quantity) == alignof(typename Quantity::value_type);
+
         template<int exp, typename T>
         constexpr auto int_pow(const T& value)
         {
             if constexpr(exp < 0)
                 return 1 / int_pow<-exp>(value);
-            if constexpr(exp == 0)
+            else if constexpr(exp == 0)
                 return T(1);
             else if constexpr(exp == 1)
                 return value;
@@ -167,8 +208,132 @@ namespace units
             else
                 return int_pow<exp / 2>(value * value) * value;
         }
+
+        /**
+         * Value of the magnitude computed in the type T
+         */
+        template<typename Magnitude, typename T>
+        constexpr T magnitude_value()
+        {
+            return meta::reduce(T(1), magnitude_as_typelist<Magnitude>(),
+                                [](const T& acc, auto factorType)
+                                {
+                                    using FactorPower = typename decltype(factorType)::type;
+                                    using Factor = typename FactorPower::Base;
+                                    if constexpr(is_int_factor<Factor>)
+                                        return acc * int_pow<FactorPower::exponent>(T(Factor::value));
+                                    else
+                                        return acc * int_pow<FactorPower::exponent>(
+                                            Factor::template value<T>());
+                                });
+        }
+
+        /**
+         * Value of the magnitude for a floating point type T
+         * It is computed once in extended precision and rounded once to T,
+         * being a constant it is never recomputed at runtime whatever the optimization level.
+         * Powers of two are represented exactly, so applying them only adjusts the
+         * exponent of the value, like ldexp.
+         */
+        template<typename Magnitude, typename T>
+        inline constexpr T magnitude_factor = static_cast<T>(magnitude_value<Magnitude, long double>());
+
+        template<typename Magnitude>
+        inline constexpr bool is_identity_magnitude = std::is_same_v<Magnitude, magnitude_raw<>>;
+
+        // std::is_signed is false for 128 bits integers in strict standard modes
+        template<typename T>
+        inline constexpr bool is_signed_integer = T(-1) < T(0);
+
+        template<typename T>
+        constexpr bool is_negative(const T& value)
+        {
+            if constexpr(is_signed_integer<T>)
+                return value < 0;
+            else
+                return false;
+        }
+
+        // Limit of T on the side of the result, for results that don't fit in T
+        template<typename T>
+        constexpr T saturated(bool negative)
+        {
+            return negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+
+        // Wide has the signedness of T and at least its range
+        template<typename T, typename Wide>
+        constexpr T saturate_cast(const Wide& value)
+        {
+            if(value > Wide(std::numeric_limits<T>::max()))
+                return std::numeric_limits<T>::max();
+            if constexpr(is_signed_integer<Wide>)
+                if(value < Wide(std::numeric_limits<T>::min()))
+                    return std::numeric_limits<T>::min();
+            return static_cast<T>(value);
+        }
+
+        // Whether value * factor overflows, for a positive factor
+        template<typename Wide>
+        constexpr bool multiply_overflows(const Wide& value, const Wide& factor)
+        {
+            if constexpr(is_signed_integer<Wide>)
+                return value > std::numeric_limits<Wide>::max() / factor ||
+                       value < std::numeric_limits<Wide>::min() / factor;
+            else
+                return value > std::numeric_limits<Wide>::max() / factor;
+        }
+
+        // Whether lhs + rhs overflows, for values of the same sign
+        template<typename Wide>
+        constexpr bool add_overflows(const Wide& lhs, const Wide& rhs)
+        {
+            if(is_negative(rhs))
+                return lhs < std::numeric_limits<Wide>::min() - rhs;
+            else
+                return lhs > std::numeric_limits<Wide>::max() - rhs;
+        }
+
+        /**
+         * Apply a power of two magnitude to an integer with shifts, even without optimizations.
+         * The result is exact and truncated toward zero, like an integer division,
+         * or saturated to the limits of T if it doesn't fit.
+         */
+        template<typename Magnitude, typename T>
+        constexpr T apply_power_of_two(const T& value)
+        {
+            using Wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+            constexpr int exp = power_of_two_magnitude<Magnitude>::exponent;
+            constexpr int max_exp = std::numeric_limits<Wide>::digits;
+            static_assert(exp < max_exp && -exp < max_exp, "The magnitude doesn't fit in the representation");
+            const Wide wide_value = value;
+
+            if constexpr(exp > 0)
+            {
+                constexpr Wide factor = Wide(1) << exp;
+                if(multiply_overflows(wide_value, factor))
+                    return saturated<T>(is_negative(wide_value));
+                if constexpr(std::is_unsigned_v<Wide>)
+                    return saturate_cast<T>(wide_value << exp);
+                else
+                    return saturate_cast<T>(wide_value * factor);
+            }
+            else if constexpr(std::is_unsigned_v<Wide>)
+                return static_cast<T>(wide_value >> -exp);
+            else
+            {
+                // Negative values are biased so that the shift truncates toward zero
+                constexpr Wide bias = (Wide(1) << -exp) - 1;
+                return static_cast<T>((wide_value < 0 ? wide_value + bias : wide_value) >> -exp);
+            }
+        }
     }
 
+    /**
+     * Apply the magnitude through a floating point factor, float or more precise.
+     * Integers scaled by a power of two are shifted instead, which is exact
+     * whatever their size and truncates toward zero like the conversion from float.
+     */
     struct ApplyMagnitudeAsFloat
     {
         template<typename Magnitude, typename T>
@@ -176,22 +341,84 @@ namespace units
         {
             // using float or more precise type
             using AccumulationType = decltype(std::declval<T>() * std::declval<float>());
-            const AccumulationType factor =
-                meta::reduce(AccumulationType(1),
-                             detail::magnitude_as_typelist<Magnitude>(),
-                             [](const AccumulationType& acc, auto factorType)
-                             {
-                                 using FactorPower = typename decltype(factorType)::type;
-                                 using Factor = typename FactorPower::Base;
-                                 if constexpr(detail::is_int_factor<Factor>)
-                                     return acc * detail::int_pow<FactorPower::exponent>(
-                                         AccumulationType(Factor::value));
-                                 else
-                                     return acc * detail::int_pow<FactorPower::exponent>(
-                                         Factor::template value<AccumulationType>());
-                             });
-
-            return factor * AccumulationType(value);
+            if constexpr(detail::is_identity_magnitude<Magnitude>)
+                return value;
+            else if constexpr(std::is_integral_v<T> && detail::power_of_two_magnitude<Magnitude>::value)
+                return detail::apply_power_of_two<Magnitude>(value);
+            else if constexpr(std::is_floating_point_v<AccumulationType>)
+                return detail::magnitude_factor<Magnitude, AccumulationType> * AccumulationType(value);
+            else
+                return detail::magnitude_value<Magnitude, AccumulationType>() * AccumulationType(value);
+        }
+    };
+
+    /**
+     * Apply the magnitude as an exact fraction on integral types.
+     * The result is truncated toward zero, like an integer division, and the
+     * intermediate product is only widened to 128 bits when it could overflow.
+     * Results that don't fit in the integral type saturate to its limits.
+     * Powers of two are applied with shifts.
+     * Other types are handled as by ApplyMagnitudeAsFloat.
+     */
+    struct ApplyMagnitudeAsRational
+    {
+        template<typename Magnitude, typename T>
+        static constexpr auto apply(const T& value)
+        {
+            if constexpr(!std::is_integral_v<T>)
+                return ApplyMagnitudeAsFloat::apply<Magnitude>(value);
+            else if constexpr(detail::is_identity_magnitude<Magnitude>)
+                return value;
+            else
+            {
+                constexpr auto ratio = detail::magnitude_ratio<Magnitude>;
+                static_assert(ratio.is_rational, "An irrational magnitude cannot be applied exactly");
+                static_assert(ratio.fits, "The magnitude doesn't fit in 64 bits");
+
+                using Wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+                constexpr auto wide_max = static_cast<uint64_t>(std::numeric_limits<Wide>::max());
+                static_assert(ratio.num <= wide_max && ratio.den <= wide_max,
+                              "The magnitude doesn't fit in the representation");
+                constexpr auto num = static_cast<Wide>(ratio.num);
+                constexpr auto den = static_cast<Wide>(ratio.den);
+                const Wide wide_value = value;
+
+                if constexpr(detail::power_of_two_magnitude<Magnitude>::value)
+                    return detail::apply_power_of_two<Magnitude>(value);
+                else if constexpr(den == 1)
+                {
+                    if(detail::multiply_overflows(wide_value, num))
+                        return detail::saturated<T>(detail::is_negative(wide_value));
+                    return detail::saturate_cast<T>(wide_value * num);
+                }
+                else if constexpr(num == 1)
+                    return static_cast<T>(wide_value / den);
+                else if constexpr(den - 1 <= std::numeric_limits<Wide>::max() / num)
+                {
+                    // value = q * den + r, q * num only overflows if the result does
+                    // and r * num cannot overflow
+                    const Wide quotient = wide_value / den;
+                    if(detail::multiply_overflows(quotient, num))
+                        return detail::saturated<T>(detail::is_negative(wide_value));
+                    const Wide high = quotient * num;
+                    const Wide low = wide_value % den * num / den;
+                    // both parts have the sign of value
+                    if(detail::add_overflows(high, low))
+                        return detail::saturated<T>(detail::is_negative(wide_value));
+                    return detail::saturate_cast<T>(high + low);
+                }
+                else
+                {
+                    #ifdef __SIZEOF_INT128__
+                    // a 64 bits value times a 64 bits numerator always fits in 128 bits
+                    using Wider = std::conditional_t<std::is_signed_v<T>, detail::int128_t, detail::uint128_t>;
+                    return detail::saturate_cast<T>(Wider(wide_value) * num / den);
+                    #else
+                    static_assert(den == 1, "The magnitude needs 128 bits integers to be applied exactly");
+                    return value;
+                    #endif
+                }
+            }
         }
     };
 
@@ -205,6 +432,18 @@ namespace units
                 return Quantity(std::move(value));
             }
 
+            template<typename Quantity>
+            static constexpr const typename Quantity::value_type& value(const Quantity& quantity)
+            {
+                return quantity.value_;
+            }
+
+            template<typename Quantity>
+            static constexpr typename Quantity::value_type& value(Quantity& quantity)
+            {
+                return quantity.value_;
+            }
+
             template<typename Quantity>
             static constexpr Quantity add(const Quantity& lhs, const Quantity& rhs)
             {
@@ -244,15 +483,86 @@ namespace units
         {
             return quantity_maker::make<quantity<Unit2, T, ApplyMagnitudePolicy>>(in<Unit2>());
         }
+
+        template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+        template<typename Unit2, typename>
+        constexpr auto quantity_base<Unit, T, ApplyMagnitudePolicy>::as_lazy(Unit2) const
+        {
+            using PendingMagnitude = MultiplyMagnitude<typename Unit::Magnitude, InverseMagnitude<typename Unit2::Magnitude>>;
+            return quantity_conversion<Unit2, T, ApplyMagnitudePolicy, PendingMagnitude>(value_);
+        }
+
         template<typename Unit, typename T, typename ApplyMagnitudePolicy>
-        template<typename OtherT, typename>
+        template<typename OtherT, typename OtherPolicy, typename>
         quantity_base<Unit, T, ApplyMagnitudePolicy>::operator quantity<
-            Unit, OtherT, ApplyMagnitudePolicy>() const
+            Unit, OtherT, OtherPolicy>() const
         {
-            return quantity_maker::make<quantity<Unit, OtherT, ApplyMagnitudePolicy>>(OtherT(value_));
+            return quantity_maker::make<quantity<Unit, OtherT, OtherPolicy>>(OtherT(value_));
         }
     }
 
+    /**
+     * A quantity of unit Unit whose conversion is still pending:
+     * its value is the stored value with PendingMagnitude applied.
+     * Converting it again with as_lazy only changes PendingMagnitude, so a chain of
+     * conversions applies a single factor, with a single rounding, when the value is
+     * read with in() or stored in a quantity.
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy, typename PendingMagnitude>
+    class quantity_conversion
+    {
+    public:
+        using value_type = T;
+        using unit = Unit;
+        using pending_magnitude = PendingMagnitude;
+
+        constexpr explicit quantity_conversion(T value) : value_{std::move(value)} {}
+
+        template<typename Unit2, typename = std::enable_if_t<
+            std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension> && detail::is_unit<Unit2>>>
+        constexpr auto as_lazy(Unit2 = {}) const
+        {
+            using NewPendingMagnitude = MultiplyMagnitude<PendingMagnitude,
+                MultiplyMagnitude<typename Unit::Magnitude, InverseMagnitude<typename Unit2::Magnitude>>>;
+            return quantity_conversion<Unit2, T, ApplyMagnitudePolicy, NewPendingMagnitude>(value_);
+        }
+
+        template<typename Unit2, typename = std::enable_if_t<
+            std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension> && detail::is_unit<Unit2>>>
+        constexpr T in(Unit2 = {}) const
+        {
+            return as_lazy<Unit2>().in_pending_unit();
+        }
+
+        template<typename Unit2, typename = std::enable_if_t<
+            std::is_same_v<typename Unit::Dimension, typename Unit2::Dimension> && detail::is_unit<Unit2>>>
+        constexpr quantity<Unit2, T, ApplyMagnitudePolicy> as(Unit2 = {}) const
+        {
+            return detail::quantity_maker::make<quantity<Unit2, T, ApplyMagnitudePolicy>>(in<Unit2>());
+        }
+
+        /**
+         * Apply the pending conversion
+         */
+        constexpr quantity<Unit, T, ApplyMagnitudePolicy> eval() const
+        {
+            return detail::quantity_maker::make<quantity<Unit, T, ApplyMagnitudePolicy>>(in_pending_unit());
+        }
+
+        constexpr operator quantity<Unit, T, ApplyMagnitudePolicy>() const { return eval(); }
+
+    private:
+        template<typename Unit2, typename T2, typename ApplyMagnitudePolicy2, typename PendingMagnitude2>
+        friend class quantity_conversion;
+
+        constexpr T in_pending_unit() const
+        {
+            return T(ApplyMagnitudePolicy::template apply<PendingMagnitude>(value_));
+        }
+
+        T value_;
+    };
+
     template<typename Unit, typename T, typename ApplyMagnitudePolicy>
     constexpr auto
     operator+(const quantity<Unit, T, ApplyMagnitudePolicy>& lhs, const quantity<Unit, T, ApplyMagnitudePolicy>& rhs)
@@ -276,27 +586,27 @@ namespace units
         return detail::quantity_maker::times<quantity<ResUnit, ResT, ApplyMagnitudePolicy>>(lhs, rhs);
     }
 
-    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2>>>
+    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2> && !detail::is_quantity_expression<T2>>>
     constexpr auto operator*(const quantity<Unit1, T1, ApplyMagnitudePolicy>& lhs,
                              const T2& rhs)
     {
         return lhs * quantity<ScalarUnit, T2, ApplyMagnitudePolicy>(rhs);
     }
 
-    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2>>>
+    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2> && !detail::is_quantity_expression<T2>>>
     constexpr auto operator*(const T2& rhs, const quantity<Unit1, T1, ApplyMagnitudePolicy>& lhs)
     {
         return lhs * quantity<ScalarUnit, T2, ApplyMagnitudePolicy>(rhs);
     }
 
-    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2>>>
+    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2> && !detail::is_quantity_expression<T2>>>
     constexpr auto operator/(const quantity<Unit1, T1, ApplyMagnitudePolicy>& lhs,
                              const T2& rhs)
     {
         return lhs / quantity<ScalarUnit, T2, ApplyMagnitudePolicy>(rhs);
     }
 
-    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2>>>
+    template<typename Unit1, typename T1, typename ApplyMagnitudePolicy, typename T2, typename = std::enable_if_t<!detail::is_unit<T2> && !detail::is_quantity<T2> && !detail::is_quantity_expression<T2>>>
     constexpr auto operator/(const T2& rhs, const quantity<Unit1, T1, ApplyMagnitudePolicy>& lhs)
     {
         return lhs / quantity<ScalarUnit, T2, ApplyMagnitudePolicy>(rhs);
@@ -314,7 +624,8 @@ namespace units
 
 // Multiply/divide scalar against unit
 template<typename Unit, typename T, typename = std::enable_if_t<
-    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T>>>
+    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T> &&
+    !units::detail::is_quantity_expression<std::decay_t<T>>>>
 constexpr auto operator*(T&& value, Unit)
 {
     return units::detail::quantity_maker::make<units::quantity<Unit, T, units::ApplyMagnitudeAsFloat>>(
@@ -322,7 +633,8 @@ constexpr auto operator*(T&& value, Unit)
 }
 
 template<typename Unit, typename T, typename = std::enable_if_t<
-    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T>>>
+    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T> &&
+    !units::detail::is_quantity_expression<std::decay_t<T>>>>
 constexpr auto operator*(Unit, T&& value)
 {
     return units::detail::quantity_maker::make<units::quantity<Unit, T, units::ApplyMagnitudeAsFloat>>(
@@ -330,7 +642,8 @@ constexpr auto operator*(Unit, T&& value)
 }
 
 template<typename Unit, typename T, typename = std::enable_if_t<
-    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T>>>
+    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T> &&
+    !units::detail::is_quantity_expression<std::decay_t<T>>>>
 constexpr auto operator/(T&& value, Unit)
 {
     return units::detail::quantity_maker::make<units::quantity<units::detail::inverse_unit<Unit>, T, units::ApplyMagnitudeAsFloat>>(
@@ -338,7 +651,8 @@ constexpr auto operator/(T&& value, Unit)
 }
 
 template<typename Unit, typename T, typename = std::enable_if_t<
-    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T>>>
+    units::detail::is_unit<Unit> && !units::detail::is_unit<T> && !units::detail::is_quantity<T> &&
+    !units::detail::is_quantity_expression<std::decay_t<T>>>>
 constexpr auto operator/(Unit, T&& value)
 {
     return units::detail::quantity_maker::make<units::quantity<Unit, T, units::ApplyMagnitudeAsFloat>>(
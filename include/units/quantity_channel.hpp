@@ -0,0 +1,363 @@
+#ifndef QUANTITY_CHANNEL_HPP
+#define QUANTITY_CHANNEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+#include "column_file.hpp"
+#include "convert.hpp"
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UNITS_QUANTITY_CHANNEL 1
+#else
+#define UNITS_QUANTITY_CHANNEL 0
+#endif
+
+
+/**
+ * Channel of quantities between two processes, or threads, through shared memory
+ *
+ * The memory holds a channel_header followed, aligned on a cache line, by a ring of
+ * capacity raw values expressed in the unit of the channel. The header describes the unit
+ * like a column of a column file, so that attaching with another unit fails.
+ * One endpoint pushes and one endpoint pops, without locks: each one only writes its own index.
+ */
+#if UNITS_QUANTITY_CHANNEL
+
+namespace units
+{
+    enum class quantity_channel_error
+    {
+        none,
+        io_error,
+        bad_format,
+        element_type_mismatch,
+        dimension_mismatch,
+        magnitude_mismatch,
+    };
+
+    namespace detail
+    {
+        inline constexpr char quantity_channel_magic[8] = {'U', 'N', 'I', 'T', 'S', 'C', 'H', 'N'};
+        inline constexpr uint32_t quantity_channel_version = 1;
+        inline constexpr size_t quantity_channel_alignment = 64;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                      "The header of a channel must be lock-free to be shared between processes");
+
+        struct quantity_channel_header
+        {
+            char magic[8];
+            // stored last, once the rest of the header is written
+            std::atomic<uint32_t> version;
+            uint32_t element_type;
+            uint64_t capacity;
+            column_signature unit;
+            // next index to write, only written by the producer
+            alignas(quantity_channel_alignment) std::atomic<uint64_t> head;
+            // next index to read, only written by the consumer
+            alignas(quantity_channel_alignment) std::atomic<uint64_t> tail;
+        };
+
+        inline constexpr size_t quantity_channel_data_offset =
+            (sizeof(quantity_channel_header) + quantity_channel_alignment - 1) / quantity_channel_alignment *
+            quantity_channel_alignment;
+    }
+
+    /**
+     * Endpoint of a single producer single consumer channel of quantities in shared memory.
+     * The values travel in ChannelUnit and are seen in Unit by this endpoint: they are
+     * converted while they are copied in and out of the ring, with the factor computed at
+     * compile time, and not copied anywhere else.
+     * `units::quantity_channel<metre, float> out;`
+     * `out.create("/dev/shm/lidar", 1 << 16);`
+     * `units::quantity_channel<millimetre, float, metre> in;`
+     * `in.attach("/dev/shm/lidar");`
+     */
+    template<typename Unit, typename T = double, typename ChannelUnit = Unit,
+             typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class quantity_channel
+    {
+        static_assert(std::is_same_v<typename Unit::Dimension, typename ChannelUnit::Dimension>,
+                      "The unit of an endpoint must have the dimension of the unit of the channel");
+
+    public:
+        using value_type = quantity<Unit, T, ApplyMagnitudePolicy>;
+
+        quantity_channel() = default;
+
+        quantity_channel(const quantity_channel&) = delete;
+
+        quantity_channel& operator=(const quantity_channel&) = delete;
+
+        quantity_channel(quantity_channel&& other) noexcept { swap(other); }
+
+        quantity_channel& operator=(quantity_channel&& other) noexcept
+        {
+            quantity_channel(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        ~quantity_channel() { close(); }
+
+        /**
+         * Create a channel in the file at path, eg in /dev/shm, able to hold capacity values.
+         * The capacity is rounded up to a power of two.
+         */
+        quantity_channel_error create(const std::string& path, size_t capacity)
+        {
+            close();
+            const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+            if(fd < 0)
+                return quantity_channel_error::io_error;
+            const quantity_channel_error error = create(fd, capacity);
+            ::close(fd);
+            return error;
+        }
+
+        /**
+         * Create a channel in the file descriptor fd, which is resized to hold capacity values
+         */
+        quantity_channel_error create(int fd, size_t capacity)
+        {
+            close();
+            assert(capacity > 0);
+            size_t slots = 1;
+            while(slots < capacity)
+                slots *= 2;
+            const size_t size = detail::quantity_channel_data_offset + slots * sizeof(T);
+            if(::ftruncate(fd, off_t(size)) != 0 || !map(fd, size))
+                return quantity_channel_error::io_error;
+
+            auto* header = new(mapping_) detail::quantity_channel_header{};
+            std::memcpy(header->magic, detail::quantity_channel_magic, sizeof(header->magic));
+            header->element_type = detail::column_element_type<T>();
+            header->capacity = slots;
+            header->unit = detail::column_signature_of<ChannelUnit>;
+            header->head.store(0, std::memory_order_relaxed);
+            header->tail.store(0, std::memory_order_relaxed);
+            // a channel being created is not attached before its version is written
+            header->version.store(detail::quantity_channel_version, std::memory_order_release);
+            use(header);
+            return quantity_channel_error::none;
+        }
+
+        #if defined(MFD_CLOEXEC)
+        /**
+         * Create a channel in anonymous memory, its file descriptor can be given to another
+         * process (inherited or sent over a unix socket) which attaches to it
+         */
+        quantity_channel_error create(size_t capacity)
+        {
+            close();
+            const int fd = ::memfd_create("units_quantity_channel", 0);
+            if(fd < 0)
+                return quantity_channel_error::io_error;
+            const quantity_channel_error error = create(fd, capacity);
+            if(error == quantity_channel_error::none)
+                fd_ = fd;
+            else
+                ::close(fd);
+            return error;
+        }
+        #endif
+
+        /**
+         * Attach to a channel created in the file at path, checking that it holds values
+         * of type T expressed in ChannelUnit
+         */
+        quantity_channel_error attach(const std::string& path)
+        {
+            close();
+            const int fd = ::open(path.c_str(), O_RDWR);
+            if(fd < 0)
+                return quantity_channel_error::io_error;
+            const quantity_channel_error error = attach(fd);
+            ::close(fd);
+            return error;
+        }
+
+        quantity_channel_error attach(int fd)
+        {
+            close();
+            struct stat status{};
+            if(::fstat(fd, &status) != 0)
+                return quantity_channel_error::io_error;
+            const size_t size = size_t(status.st_size);
+            if(size < detail::quantity_channel_data_offset)
+                return quantity_channel_error::bad_format;
+            if(!map(fd, size))
+                return quantity_channel_error::io_error;
+
+            const quantity_channel_error error = check(size);
+            if(error != quantity_channel_error::none)
+            {
+                close();
+                return error;
+            }
+            use(std::launder(reinterpret_cast<detail::quantity_channel_header*>(mapping_)));
+            return quantity_channel_error::none;
+        }
+
+        void close()
+        {
+            if(mapping_)
+                ::munmap(mapping_, mapping_size_);
+            if(fd_ >= 0)
+                ::close(fd_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            header_ = nullptr;
+            capacity_ = 0;
+            slots_ = nullptr;
+            fd_ = -1;
+        }
+
+        bool is_open() const { return header_ != nullptr; }
+
+        /**
+         * File descriptor of a channel created in anonymous memory, -1 otherwise
+         */
+        int fd() const { return fd_; }
+
+        size_t capacity() const { return capacity_; }
+
+        /**
+         * Number of values waiting to be popped, it may already be outdated
+         */
+        size_t size() const
+        {
+            return size_t(header_->head.load(std::memory_order_acquire) - header_->tail.load(std::memory_order_acquire));
+        }
+
+        /**
+         * Push up to n quantities and return how many were pushed,
+         * fewer than n when the ring is full. Only one endpoint may push.
+         */
+        size_t push(const value_type* data, size_t n)
+        {
+            const uint64_t head = header_->head.load(std::memory_order_relaxed);
+            if(capacity() - std::min(size_t(head - cached_tail_), capacity()) < n)
+                cached_tail_ = header_->tail.load(std::memory_order_acquire);
+            // the indices are shared with another process, they are not trusted to stay in the ring
+            const size_t used = std::min(size_t(head - cached_tail_), capacity());
+            const size_t count = std::min(n, capacity() - used);
+            const T* values = reinterpret_cast<const T*>(data);
+            const size_t first = size_t(head) & (capacity() - 1);
+            const size_t before_end = std::min(count, capacity() - first);
+            convert_values<Unit, ChannelUnit, ApplyMagnitudePolicy>(values, slots_ + first, before_end);
+            convert_values<Unit, ChannelUnit, ApplyMagnitudePolicy>(values + before_end, slots_, count - before_end);
+            header_->head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        bool push(const value_type& q) { return push(&q, 1) == 1; }
+
+        /**
+         * Pop up to n quantities into out and return how many were popped,
+         * fewer than n when the ring is empty. Only one endpoint may pop.
+         */
+        size_t pop(value_type* out, size_t n)
+        {
+            const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+            if(size_t(cached_head_ - tail) < n)
+                cached_head_ = header_->head.load(std::memory_order_acquire);
+            const size_t count = std::min({n, size_t(cached_head_ - tail), capacity()});
+            T* values = reinterpret_cast<T*>(out);
+            const size_t first = size_t(tail) & (capacity() - 1);
+            const size_t before_end = std::min(count, capacity() - first);
+            convert_values<ChannelUnit, Unit, ApplyMagnitudePolicy>(slots_ + first, values, before_end);
+            convert_values<ChannelUnit, Unit, ApplyMagnitudePolicy>(slots_, values + before_end, count - before_end);
+            header_->tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        std::optional<value_type> pop()
+        {
+            std::optional<value_type> q = detail::quantity_maker::make<value_type>(T{});
+            if(pop(&*q, 1) == 0)
+                return std::nullopt;
+            return q;
+        }
+
+    private:
+        static_assert(detail::is_layout_compatible_quantity<value_type>);
+
+        bool map(int fd, size_t size)
+        {
+            void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if(address == MAP_FAILED)
+                return false;
+            mapping_ = address;
+            mapping_size_ = size;
+            return true;
+        }
+
+        quantity_channel_error check(size_t size) const
+        {
+            const auto* header = static_cast<const detail::quantity_channel_header*>(mapping_);
+            if(header->version.load(std::memory_order_acquire) != detail::quantity_channel_version ||
+               std::memcmp(header->magic, detail::quantity_channel_magic, sizeof(header->magic)) != 0 ||
+               header->capacity == 0 ||
+               (header->capacity & (header->capacity - 1)) != 0 ||
+               header->capacity > (size - detail::quantity_channel_data_offset) / sizeof(T) ||
+               uint64_t(header->unit.dimension_count) + header->unit.magnitude_count > detail::column_term_capacity)
+                return quantity_channel_error::bad_format;
+            if(header->element_type != detail::column_element_type<T>())
+                return quantity_channel_error::element_type_mismatch;
+
+            constexpr detail::column_signature expected = detail::column_signature_of<ChannelUnit>;
+            if(!header->unit.same_dimension(expected))
+                return quantity_channel_error::dimension_mismatch;
+            if(!header->unit.same_magnitude(expected))
+                return quantity_channel_error::magnitude_mismatch;
+            return quantity_channel_error::none;
+        }
+
+        void use(detail::quantity_channel_header* header)
+        {
+            header_ = header;
+            capacity_ = size_t(header->capacity);
+            slots_ = reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + detail::quantity_channel_data_offset);
+            cached_head_ = header->head.load(std::memory_order_acquire);
+            cached_tail_ = header->tail.load(std::memory_order_acquire);
+        }
+
+        void swap(quantity_channel& other) noexcept
+        {
+            std::swap(mapping_, other.mapping_);
+            std::swap(mapping_size_, other.mapping_size_);
+            std::swap(header_, other.header_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(slots_, other.slots_);
+            std::swap(fd_, other.fd_);
+            std::swap(cached_head_, other.cached_head_);
+            std::swap(cached_tail_, other.cached_tail_);
+        }
+
+        void* mapping_ = nullptr;
+        size_t mapping_size_ = 0;
+        detail::quantity_channel_header* header_ = nullptr;
+        // copy of the capacity checked when the channel was opened
+        size_t capacity_ = 0;
+        T* slots_ = nullptr;
+        int fd_ = -1;
+        // copies of the index of the other endpoint, only read again when they seem to block
+        uint64_t cached_head_ = 0;
+        uint64_t cached_tail_ = 0;
+    };
+}
+
+#endif
+
+#endif // QUANTITY_CHANNEL_HPP
@@ -0,0 +1,163 @@
+#ifndef QUANTITY_SPAN_HPP
+#define QUANTITY_SPAN_HPP
+
+#include <cstddef>
+#include <iterator>
+#include "quantity.hpp"
+#include "span.hpp"
+
+
+namespace units
+{
+    namespace detail
+    {
+        // quantity<Unit, T> for a possibly const T, with the same constness
+        template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+        using quantity_view_element = std::conditional_t<std::is_const_v<T>,
+            const quantity<Unit, std::remove_const_t<T>, ApplyMagnitudePolicy>,
+            quantity<Unit, T, ApplyMagnitudePolicy>>;
+    }
+
+    /**
+     * Non owning view of contiguous raw values of type T, expressed in Unit, as quantities.
+     * Nothing is copied, T can be const to view read only memory.
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class quantity_span
+    {
+    public:
+        using unit = Unit;
+        using element_type = detail::quantity_view_element<Unit, T, ApplyMagnitudePolicy>;
+        using value_type = std::remove_const_t<element_type>;
+        using raw_type = T;
+        using size_type = size_t;
+        using iterator = element_type*;
+
+        static_assert(detail::is_layout_compatible_quantity<value_type>);
+
+        constexpr quantity_span() = default;
+
+        quantity_span(T* data, size_t size) : data_{reinterpret_cast<element_type*>(data)}, size_{size} {}
+
+        explicit quantity_span(span<T> values) : quantity_span(values.data(), values.size()) {}
+
+        constexpr element_type* data() const { return data_; }
+
+        constexpr size_t size() const { return size_; }
+
+        constexpr bool empty() const { return size_ == 0; }
+
+        constexpr element_type& operator[](size_t index) const { return data_[index]; }
+
+        constexpr iterator begin() const { return data_; }
+
+        constexpr iterator end() const { return data_ + size_; }
+
+        span<T> raw() const { return span<T>(reinterpret_cast<T*>(data_), size_); }
+
+    private:
+        element_type* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    /**
+     * Non owning view of raw values of type T, expressed in Unit, placed at
+     * regular intervals in memory, eg a field of an array of structs.
+     * The stride is in bytes. Nothing is copied, T can be const to view read only memory.
+     */
+    template<typename Unit, typename T, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class strided_quantity_span
+    {
+        using byte_type = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+    public:
+        using unit = Unit;
+        using element_type = detail::quantity_view_element<Unit, T, ApplyMagnitudePolicy>;
+        using value_type = std::remove_const_t<element_type>;
+        using raw_type = T;
+        using size_type = size_t;
+
+        static_assert(detail::is_layout_compatible_quantity<value_type>);
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = strided_quantity_span::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = element_type*;
+            using reference = element_type&;
+
+            iterator() = default;
+
+            reference operator*() const { return *reinterpret_cast<element_type*>(position_); }
+
+            pointer operator->() const { return &**this; }
+
+            iterator& operator++()
+            {
+                position_ += stride_;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const iterator& other) const { return position_ == other.position_; }
+
+            bool operator!=(const iterator& other) const { return position_ != other.position_; }
+
+        private:
+            friend class strided_quantity_span;
+
+            iterator(byte_type* position, size_t stride) : position_{position}, stride_{stride} {}
+
+            byte_type* position_ = nullptr;
+            size_t stride_ = 0;
+        };
+
+        strided_quantity_span() = default;
+
+        strided_quantity_span(T* first, size_t size, size_t stride) :
+            first_{reinterpret_cast<byte_type*>(first)}, size_{size}, stride_{stride}
+        {}
+
+        size_t size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        size_t stride() const { return stride_; }
+
+        element_type& operator[](size_t index) const
+        {
+            return *reinterpret_cast<element_type*>(first_ + index * stride_);
+        }
+
+        iterator begin() const { return iterator(first_, stride_); }
+
+        iterator end() const { return iterator(first_ + size_ * stride_, stride_); }
+
+    private:
+        byte_type* first_ = nullptr;
+        size_t size_ = 0;
+        size_t stride_ = 0;
+    };
+
+    /**
+     * View a field of an array of records as quantities of Unit, eg
+     * `auto altitudes = units::make_strided_quantity_span<metre>(samples, count, &Sample::altitude);`
+     */
+    template<typename Unit, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat, typename Record, typename T>
+    auto make_strided_quantity_span(Record* records, size_t size, T std::remove_const_t<Record>::* field)
+    {
+        using Raw = std::conditional_t<std::is_const_v<Record>, const T, T>;
+        Raw* first = size > 0 ? &(records->*field) : nullptr;
+        return strided_quantity_span<Unit, Raw, ApplyMagnitudePolicy>(first, size, sizeof(Record));
+    }
+}
+
+#endif // QUANTITY_SPAN_HPP
@@ -0,0 +1,144 @@
+#ifndef QUANTITY_VECTOR_HPP
+#define QUANTITY_VECTOR_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "convert.hpp"
+#include "span.hpp"
+
+
+namespace units
+{
+    /**
+     * Contiguous container of quantities of the same unit.
+     *
+     * The values are stored as a plain std::vector<T, Allocator> so they can be
+     * handed over as raw values with raw() or release(), and a raw buffer can be
+     * adopted without copy.
+     * The elements are accessed as quantities, which are layout compatible with T.
+     */
+    template<typename Unit, typename T = double, typename Allocator = std::allocator<T>,
+             typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class quantity_vector
+    {
+    public:
+        using unit = Unit;
+        using value_type = quantity<Unit, T, ApplyMagnitudePolicy>;
+        using raw_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using iterator = value_type*;
+        using const_iterator = const value_type*;
+
+        static_assert(detail::is_layout_compatible_quantity<value_type>);
+
+        quantity_vector() = default;
+
+        explicit quantity_vector(const Allocator& allocator) : values_(allocator) {}
+
+        quantity_vector(size_t size, const value_type& value, const Allocator& allocator = Allocator()) :
+            values_(size, detail::quantity_maker::value(value), allocator)
+        {}
+
+        /**
+         * Adopt a buffer of raw values, expressed in Unit
+         */
+        explicit quantity_vector(std::vector<T, Allocator> raw_values) : values_(std::move(raw_values)) {}
+
+        allocator_type get_allocator() const { return values_.get_allocator(); }
+
+        size_t size() const { return values_.size(); }
+
+        bool empty() const { return values_.empty(); }
+
+        size_t capacity() const { return values_.capacity(); }
+
+        void reserve(size_t capacity) { values_.reserve(capacity); }
+
+        void clear() { values_.clear(); }
+
+        void resize(size_t size) { values_.resize(size); }
+
+        void resize(size_t size, const value_type& value)
+        {
+            values_.resize(size, detail::quantity_maker::value(value));
+        }
+
+        value_type* data() { return reinterpret_cast<value_type*>(values_.data()); }
+
+        const value_type* data() const { return reinterpret_cast<const value_type*>(values_.data()); }
+
+        reference operator[](size_t index) { return data()[index]; }
+
+        const_reference operator[](size_t index) const { return data()[index]; }
+
+        iterator begin() { return data(); }
+
+        iterator end() { return data() + size(); }
+
+        const_iterator begin() const { return data(); }
+
+        const_iterator end() const { return data() + size(); }
+
+        void push_back(const value_type& value) { values_.push_back(detail::quantity_maker::value(value)); }
+
+        /**
+         * Append raw values expressed in Unit, this is a plain copy of the values
+         */
+        void append_raw(const T* values, size_t count) { values_.insert(values_.end(), values, values + count); }
+
+        /**
+         * Append quantities of any unit of the same dimension, converting them in one pass
+         */
+        template<typename Unit2>
+        void append(const quantity<Unit2, T, ApplyMagnitudePolicy>* values, size_t count)
+        {
+            const size_t offset = values_.size();
+            values_.resize(offset + count);
+            convert_values<Unit2, Unit, ApplyMagnitudePolicy>(
+                reinterpret_cast<const T*>(values), values_.data() + offset, count);
+        }
+
+        /**
+         * View of the raw values, expressed in Unit
+         */
+        span<T> raw() { return span<T>(values_.data(), values_.size()); }
+
+        span<const T> raw() const { return span<const T>(values_.data(), values_.size()); }
+
+        /**
+         * Convert every value to Unit2 in place and move the buffer into
+         * a vector of Unit2, no allocation is done
+         */
+        template<typename Unit2>
+        quantity_vector<Unit2, T, Allocator, ApplyMagnitudePolicy> rescale(Unit2 = {}) &&
+        {
+            convert_values<Unit, Unit2, ApplyMagnitudePolicy>(values_.data(), values_.data(), values_.size());
+            return quantity_vector<Unit2, T, Allocator, ApplyMagnitudePolicy>(std::move(values_));
+        }
+
+        /**
+         * Give the buffer of raw values, expressed in Unit, back
+         */
+        std::vector<T, Allocator> release() && { return std::move(values_); }
+
+    private:
+        std::vector<T, Allocator> values_;
+    };
+
+    namespace pmr
+    {
+        /**
+         * quantity_vector using a polymorphic allocator, eg to allocate from an arena
+         * with std::pmr::monotonic_buffer_resource
+         */
+        template<typename Unit, typename T = double, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+        using quantity_vector =
+            units::quantity_vector<Unit, T, std::pmr::polymorphic_allocator<T>, ApplyMagnitudePolicy>;
+    }
+}
+
+#endif // QUANTITY_VECTOR_HPP
@@ -0,0 +1,339 @@
+#ifndef SERIALIZE_HPP
+#define SERIALIZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "column_file.hpp"
+#include "convert.hpp"
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define UNITS_WIRE_BIG_ENDIAN 1
+#else
+#define UNITS_WIRE_BIG_ENDIAN 0
+#endif
+
+
+/**
+ * Binary wire format of quantities
+ *
+ * A quantity is written as an optional fingerprint of its unit and value type,
+ * followed by its raw value. An array is written as the optional fingerprint,
+ * the number of values on 64 bits, then the raw values one after the other.
+ * Everything is in little endian, so that on little endian hosts arrays are
+ * written and read with a single memcpy.
+ */
+namespace units
+{
+    /**
+     * Size of the fingerprint written before the values, none to write only the values
+     */
+    enum class fingerprint_size : uint8_t
+    {
+        none = 0,
+        bits32 = 4,
+        bits64 = 8,
+    };
+
+    enum class wire_error
+    {
+        none,
+        // the buffer is too small for what is to be written or read
+        truncated,
+        // the values are not of the expected unit or value type
+        fingerprint_mismatch,
+        // more values than the output can hold
+        too_many_values,
+    };
+
+    struct wire_result
+    {
+        // number of bytes written or read
+        size_t size = 0;
+        // number of quantities written or read
+        size_t count = 0;
+        wire_error error = wire_error::none;
+    };
+
+    namespace detail
+    {
+        // FNV-1a of the little endian bytes of value
+        constexpr uint64_t hash_bytes(uint64_t hash, uint64_t value, size_t size)
+        {
+            for(size_t i = 0; i < size; ++i)
+            {
+                hash ^= (value >> (8 * i)) & 0xffu;
+                hash *= 0x100000001b3u;
+            }
+            return hash;
+        }
+
+        constexpr uint64_t hash_signature(const column_signature& signature, uint32_t element_type)
+        {
+            uint64_t hash = 0xcbf29ce484222325u;
+            hash = hash_bytes(hash, signature.dimension_count, 4);
+            hash = hash_bytes(hash, signature.magnitude_count, 4);
+            for(uint32_t i = 0; i < signature.dimension_count + signature.magnitude_count; ++i)
+            {
+                hash = hash_bytes(hash, uint32_t(signature.terms[i].kind), 4);
+                hash = hash_bytes(hash, uint32_t(signature.terms[i].exponent), 4);
+                hash = hash_bytes(hash, signature.terms[i].id, 8);
+            }
+            return hash_bytes(hash, element_type, 4);
+        }
+
+        template<typename T>
+        T byte_swap(T value)
+        {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            for(size_t i = 0; i < sizeof(T) / 2; ++i)
+            {
+                const unsigned char byte = bytes[i];
+                bytes[i] = bytes[sizeof(T) - 1 - i];
+                bytes[sizeof(T) - 1 - i] = byte;
+            }
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+
+        // n values of type T between native and little endian memory
+        template<typename T>
+        void copy_little_endian(const void* in, void* out, size_t n)
+        {
+            if(n == 0)
+                return;
+            #if UNITS_WIRE_BIG_ENDIAN
+            const auto* from = static_cast<const unsigned char*>(in);
+            auto* to = static_cast<unsigned char*>(out);
+            for(size_t i = 0; i < n; ++i)
+            {
+                T value;
+                std::memcpy(&value, from + i * sizeof(T), sizeof(T));
+                value = byte_swap(value);
+                std::memcpy(to + i * sizeof(T), &value, sizeof(T));
+            }
+            #else
+            std::memcpy(out, in, n * sizeof(T));
+            #endif
+        }
+
+        template<fingerprint_size Fingerprint, typename Unit, typename T>
+        constexpr uint64_t make_wire_fingerprint()
+        {
+            if constexpr(Fingerprint == fingerprint_size::none)
+                return 0;
+            else
+            {
+                static_assert(has_stable_signature<Unit>,
+                              "The base dimensions and irrational factors of a fingerprinted unit need an ordinal");
+                if constexpr(has_stable_signature<Unit>)
+                    return hash_signature(column_signature_of<Unit>, column_element_type<T>()) &
+                        (Fingerprint == fingerprint_size::bits32 ? 0xffffffffu : ~uint64_t(0));
+                else
+                    return 0;
+            }
+        }
+
+        template<fingerprint_size Fingerprint, typename Unit, typename T>
+        inline constexpr uint64_t wire_fingerprint_value = make_wire_fingerprint<Fingerprint, Unit, T>();
+
+        template<fingerprint_size Fingerprint>
+        void write_fingerprint(std::byte* out, uint64_t fingerprint)
+        {
+            if constexpr(Fingerprint == fingerprint_size::bits32)
+            {
+                const uint32_t value = uint32_t(fingerprint);
+                copy_little_endian<uint32_t>(&value, out, 1);
+            }
+            else if constexpr(Fingerprint == fingerprint_size::bits64)
+                copy_little_endian<uint64_t>(&fingerprint, out, 1);
+        }
+
+        template<fingerprint_size Fingerprint>
+        uint64_t read_fingerprint(const std::byte* in)
+        {
+            if constexpr(Fingerprint == fingerprint_size::bits32)
+            {
+                uint32_t value = 0;
+                copy_little_endian<uint32_t>(in, &value, 1);
+                return value;
+            }
+            else if constexpr(Fingerprint == fingerprint_size::bits64)
+            {
+                uint64_t value = 0;
+                copy_little_endian<uint64_t>(in, &value, 1);
+                return value;
+            }
+            else
+                return 0;
+        }
+
+        template<typename From, typename To, typename ApplyMagnitudePolicy, typename T>
+        void rescale_values(T* values, size_t n)
+        {
+            convert_values<From, To, ApplyMagnitudePolicy>(values, values, n);
+        }
+
+        /**
+         * Find the conversion from the unit whose fingerprint was read to Unit: none if it is the
+         * fingerprint of Unit, otherwise the one from the first sender unit with this fingerprint.
+         * Returns false if none matches.
+         */
+        template<fingerprint_size Fingerprint, typename Unit, typename T, typename ApplyMagnitudePolicy,
+                 typename... SenderUnits>
+        bool find_rescale(uint64_t fingerprint, void (*&rescale)(T*, size_t))
+        {
+            rescale = nullptr;
+            if constexpr(Fingerprint == fingerprint_size::none)
+                return true;
+            else
+            {
+                if(fingerprint == wire_fingerprint_value<Fingerprint, Unit, T>)
+                    return true;
+                [[maybe_unused]] auto try_sender = [&](auto sender_type)
+                {
+                    using Sender = typename decltype(sender_type)::type;
+                    static_assert(std::is_same_v<typename Sender::Dimension, typename Unit::Dimension>,
+                                  "Only units of the same dimension can be received");
+                    if(!rescale && fingerprint == wire_fingerprint_value<Fingerprint, Sender, T>)
+                        rescale = &rescale_values<Sender, Unit, ApplyMagnitudePolicy, T>;
+                };
+                (try_sender(meta::type<SenderUnits>), ...);
+                return rescale != nullptr;
+            }
+        }
+    }
+
+    /**
+     * Fingerprint of a unit and a value type as written on the wire, computed at compile time.
+     * It is made of the base dimensions and the factors of the magnitude raised to their
+     * exponents, and of the kind and size of T. Base dimensions and irrational factors are
+     * identified by their ordinal (see meta::ordinal), which they must have so that the
+     * fingerprint is the same with every compiler. Values written without fingerprint have
+     * no such requirement.
+     */
+    template<typename Unit, typename T, fingerprint_size Fingerprint = fingerprint_size::bits64>
+    inline constexpr uint64_t wire_fingerprint = detail::wire_fingerprint_value<Fingerprint, Unit, T>;
+
+    /**
+     * Number of bytes written by serialize for one quantity of type T
+     */
+    template<typename T, fingerprint_size Fingerprint = fingerprint_size::bits64>
+    constexpr size_t serialized_size() { return size_t(Fingerprint) + sizeof(T); }
+
+    /**
+     * Number of bytes written by serialize for an array of n quantities of type T
+     */
+    template<typename T, fingerprint_size Fingerprint = fingerprint_size::bits64>
+    constexpr size_t serialized_size(size_t n) { return size_t(Fingerprint) + sizeof(uint64_t) + n * sizeof(T); }
+
+    /**
+     * Write a quantity in out, which can hold size bytes
+     */
+    template<fingerprint_size Fingerprint = fingerprint_size::bits64, typename Unit, typename T,
+             typename ApplyMagnitudePolicy>
+    wire_result serialize(const quantity<Unit, T, ApplyMagnitudePolicy>& q, std::byte* out, size_t size)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be serialized");
+        if(size < serialized_size<T, Fingerprint>())
+            return {0, 0, wire_error::truncated};
+        detail::write_fingerprint<Fingerprint>(out, wire_fingerprint<Unit, T, Fingerprint>);
+        detail::copy_little_endian<T>(&detail::quantity_maker::value(q), out + size_t(Fingerprint), 1);
+        return {serialized_size<T, Fingerprint>(), 1, wire_error::none};
+    }
+
+    /**
+     * Write an array of n quantities in out, which can hold size bytes
+     */
+    template<fingerprint_size Fingerprint = fingerprint_size::bits64, typename Unit, typename T,
+             typename ApplyMagnitudePolicy>
+    wire_result serialize(const quantity<Unit, T, ApplyMagnitudePolicy>* data, size_t n, std::byte* out, size_t size)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be serialized");
+        static_assert(detail::is_layout_compatible_quantity<quantity<Unit, T, ApplyMagnitudePolicy>>);
+        if(size < serialized_size<T, Fingerprint>(n))
+            return {0, 0, wire_error::truncated};
+        detail::write_fingerprint<Fingerprint>(out, wire_fingerprint<Unit, T, Fingerprint>);
+        const uint64_t count = n;
+        detail::copy_little_endian<uint64_t>(&count, out + size_t(Fingerprint), 1);
+        detail::copy_little_endian<T>(data, out + size_t(Fingerprint) + sizeof(uint64_t), n);
+        return {serialized_size<T, Fingerprint>(n), n, wire_error::none};
+    }
+
+    /**
+     * Read a quantity written by serialize from in, which holds size bytes.
+     * The fingerprint must be the one of the unit of out, or of one of SenderUnits
+     * in which case the value is converted to the unit of out.
+     * `units::deserialize<units::fingerprint_size::bits64, kilometre, mile>(buffer, size, distance_in_metres);`
+     */
+    template<fingerprint_size Fingerprint = fingerprint_size::bits64, typename... SenderUnits, typename Unit,
+             typename T, typename ApplyMagnitudePolicy>
+    wire_result deserialize(const std::byte* in, size_t size, quantity<Unit, T, ApplyMagnitudePolicy>& out)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be deserialized");
+        if(size < serialized_size<T, Fingerprint>())
+            return {0, 0, wire_error::truncated};
+        void (*rescale)(T*, size_t) = nullptr;
+        if(!detail::find_rescale<Fingerprint, Unit, T, ApplyMagnitudePolicy, SenderUnits...>(
+               detail::read_fingerprint<Fingerprint>(in), rescale))
+            return {0, 0, wire_error::fingerprint_mismatch};
+        T value;
+        detail::copy_little_endian<T>(in + size_t(Fingerprint), &value, 1);
+        if(rescale)
+            rescale(&value, 1);
+        out = detail::quantity_maker::make<quantity<Unit, T, ApplyMagnitudePolicy>>(value);
+        return {serialized_size<T, Fingerprint>(), 1, wire_error::none};
+    }
+
+    /**
+     * Read an array written by serialize from in, which holds size bytes, into out which
+     * can hold capacity quantities (see serialized_count).
+     * The fingerprint is checked like for a single quantity, the values are copied with a
+     * single memcpy on little endian hosts and then converted if they come from a sender unit.
+     */
+    template<fingerprint_size Fingerprint = fingerprint_size::bits64, typename... SenderUnits, typename Unit,
+             typename T, typename ApplyMagnitudePolicy>
+    wire_result deserialize(const std::byte* in, size_t size, quantity<Unit, T, ApplyMagnitudePolicy>* out,
+                            size_t capacity)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be deserialized");
+        static_assert(detail::is_layout_compatible_quantity<quantity<Unit, T, ApplyMagnitudePolicy>>);
+        if(size < serialized_size<T, Fingerprint>(0))
+            return {0, 0, wire_error::truncated};
+        uint64_t count = 0;
+        detail::copy_little_endian<uint64_t>(in + size_t(Fingerprint), &count, 1);
+        if(count > capacity)
+            return {0, 0, wire_error::too_many_values};
+        const size_t n = size_t(count);
+        if(size < serialized_size<T, Fingerprint>(n))
+            return {0, 0, wire_error::truncated};
+
+        void (*rescale)(T*, size_t) = nullptr;
+        if(!detail::find_rescale<Fingerprint, Unit, T, ApplyMagnitudePolicy, SenderUnits...>(
+               detail::read_fingerprint<Fingerprint>(in), rescale))
+            return {0, 0, wire_error::fingerprint_mismatch};
+        T* values = reinterpret_cast<T*>(out);
+        detail::copy_little_endian<T>(in + serialized_size<T, Fingerprint>(0), values, n);
+        if(rescale)
+            rescale(values, n);
+        return {serialized_size<T, Fingerprint>(n), n, wire_error::none};
+    }
+
+    /**
+     * Number of quantities of an array written by serialize, in result.count, without reading them
+     */
+    template<typename T, fingerprint_size Fingerprint = fingerprint_size::bits64>
+    wire_result serialized_count(const std::byte* in, size_t size)
+    {
+        if(size < serialized_size<T, Fingerprint>(0))
+            return {0, 0, wire_error::truncated};
+        uint64_t count = 0;
+        detail::copy_little_endian<uint64_t>(in + size_t(Fingerprint), &count, 1);
+        return {serialized_size<T, Fingerprint>(0), size_t(count), wire_error::none};
+    }
+}
+
+#undef UNITS_WIRE_BIG_ENDIAN
+
+#endif // SERIALIZE_HPP
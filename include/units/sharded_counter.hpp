@@ -0,0 +1,112 @@
+#ifndef SHARDED_COUNTER_HPP
+#define SHARDED_COUNTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include "atomic_quantity.hpp"
+
+
+namespace units
+{
+    namespace detail
+    {
+        /**
+         * Index given to each thread the first time it asks for one,
+         * so that consecutive threads use different shards
+         */
+        inline size_t thread_shard_index()
+        {
+            static std::atomic<size_t> next_index{0};
+            thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        inline size_t default_shard_count()
+        {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    /**
+     * Counter updated by many threads at a high rate, eg bytes sent or energy used.
+     * Each thread adds to its own shard, on its own cache line, so that the threads don't
+     * contend with each other as long as there are at least as many shards as threads.
+     * add() is a single relaxed atomic addition, wait-free for integers; read() sums
+     * every shard and is meant to be called much less often.
+     * Quantities of any unit of the dimension of Unit can be added, see atomic_quantity.
+     */
+    template<typename Unit, typename T = double, typename ApplyMagnitudePolicy = ApplyMagnitudeAsFloat>
+    class sharded_quantity_counter
+    {
+    public:
+        using unit = Unit;
+        using value_type = quantity<Unit, T, ApplyMagnitudePolicy>;
+
+        /**
+         * The number of shards is rounded up to a power of two, by default it is
+         * the number of hardware threads
+         */
+        explicit sharded_quantity_counter(size_t shards = detail::default_shard_count()) :
+            mask_{round_up(shards) - 1}, shards_{std::make_unique<shard[]>(mask_ + 1)}
+        {}
+
+        size_t shard_count() const { return mask_ + 1; }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        void add(const quantity<Unit2, T2, Policy2>& q)
+        {
+            shards_[detail::thread_shard_index() & mask_].value.fetch_add(q, std::memory_order_relaxed);
+        }
+
+        template<typename Unit2, typename T2, typename Policy2>
+        sharded_quantity_counter& operator+=(const quantity<Unit2, T2, Policy2>& q)
+        {
+            add(q);
+            return *this;
+        }
+
+        /**
+         * Sum of the shards. Additions made while it is read may or may not be counted.
+         */
+        value_type read() const
+        {
+            T total{};
+            for(size_t i = 0; i <= mask_; ++i)
+                total = T(total + detail::quantity_maker::value(shards_[i].value.load(std::memory_order_relaxed)));
+            return detail::quantity_maker::make<value_type>(total);
+        }
+
+        /**
+         * Set every shard back to zero, the additions made meanwhile may be lost
+         */
+        void reset()
+        {
+            const value_type zero = detail::quantity_maker::make<value_type>(T{});
+            for(size_t i = 0; i <= mask_; ++i)
+                shards_[i].value.store(zero, std::memory_order_relaxed);
+        }
+
+    private:
+        struct alignas(64) shard
+        {
+            atomic_quantity<Unit, T, ApplyMagnitudePolicy> value;
+        };
+
+        static size_t round_up(size_t shards)
+        {
+            assert(shards > 0);
+            size_t count = 1;
+            while(count < shards)
+                count *= 2;
+            return count;
+        }
+
+        size_t mask_;
+        std::unique_ptr<shard[]> shards_;
+    };
+}
+
+#endif // SHARDED_COUNTER_HPP
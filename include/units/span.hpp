@@ -0,0 +1,54 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace units
+{
+    /**
+     * Non owning view over contiguous values
+     * This is a minimal equivalent of C++20 std::span since the library targets C++17.
+     */
+    template<typename T>
+    class span
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = size_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        constexpr span() = default;
+
+        constexpr span(T* data, size_t size) : data_{data}, size_{size} {}
+
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        constexpr span(const span<U>& other) : data_{other.data()}, size_{other.size()} {}
+
+        constexpr T* data() const { return data_; }
+
+        constexpr size_t size() const { return size_; }
+
+        constexpr size_t size_bytes() const { return size_ * sizeof(T); }
+
+        constexpr bool empty() const { return size_ == 0; }
+
+        constexpr T& operator[](size_t index) const { return data_[index]; }
+
+        constexpr T* begin() const { return data_; }
+
+        constexpr T* end() const { return data_ + size_; }
+
+        constexpr span subspan(size_t offset, size_t count) const { return span(data_ + offset, count); }
+
+    private:
+        T* data_ = nullptr;
+        size_t size_ = 0;
+    };
+}
+
+#endif // SPAN_HPP
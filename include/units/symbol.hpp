@@ -0,0 +1,334 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "type_name.hpp"
+#include "unit.hpp"
+
+
+namespace units
+{
+    /**
+     * Symbol of a unit, eg "km".
+     * A unit opts in either by declaring a member
+     * `static constexpr std::string_view symbol = "km";`
+     * or by specializing this trait with a `value` member.
+     * Irrational factors of magnitudes (see units::pi) opt in the same way.
+     */
+    template<typename Unit, typename = void>
+    struct unit_symbol {};
+
+    template<typename Unit>
+    struct unit_symbol<Unit, std::void_t<decltype(Unit::symbol)>>
+    {
+        static constexpr std::string_view value = Unit::symbol;
+    };
+
+    template<typename Unit, typename = void>
+    struct has_unit_symbol : std::false_type {};
+
+    template<typename Unit>
+    struct has_unit_symbol<Unit, std::void_t<decltype(unit_symbol<Unit>::value)>> : std::true_type {};
+
+    template<typename Unit>
+    inline constexpr bool has_unit_symbol_v = has_unit_symbol<Unit>::value;
+
+    /**
+     * Symbol of a dimension, eg "L" for a length.
+     * A dimension opts in the same way as a unit for unit_symbol.
+     */
+    template<typename Dimension, typename = void>
+    struct dimension_symbol {};
+
+    template<typename Dimension>
+    struct dimension_symbol<Dimension, std::void_t<decltype(Dimension::symbol)>>
+    {
+        static constexpr std::string_view value = Dimension::symbol;
+    };
+
+    template<typename Dimension, typename = void>
+    struct has_dimension_symbol : std::false_type {};
+
+    template<typename Dimension>
+    struct has_dimension_symbol<Dimension, std::void_t<decltype(dimension_symbol<Dimension>::value)>>
+        : std::true_type {};
+
+    template<typename Dimension>
+    inline constexpr bool has_dimension_symbol_v = has_dimension_symbol<Dimension>::value;
+
+    namespace detail
+    {
+        /**
+         * Writes a symbol, or only counts its characters when out is null
+         * so that the exact storage can be computed first
+         */
+        struct symbol_writer
+        {
+            char* out = nullptr;
+            size_t size = 0;
+            bool separate = false;
+
+            constexpr void put(char c)
+            {
+                if(out)
+                    out[size] = c;
+                ++size;
+            }
+
+            constexpr void put(std::string_view text)
+            {
+                for(char c : text)
+                    put(c);
+            }
+
+            constexpr void put(uint64_t value)
+            {
+                char digits[20] = {};
+                size_t count = 0;
+                do
+                {
+                    digits[count++] = char('0' + value % 10);
+                    value /= 10;
+                } while(value != 0);
+                while(count > 0)
+                    put(digits[--count]);
+            }
+
+            // exponent in superscript, symbols are in UTF-8
+            constexpr void put_exponent(int exponent)
+            {
+                constexpr std::string_view superscripts[] = {
+                    "\u2070", "\u00b9", "\u00b2", "\u00b3", "\u2074",
+                    "\u2075", "\u2076", "\u2077", "\u2078", "\u2079"};
+                if(exponent == 1)
+                    return;
+                if(exponent < 0)
+                    put(std::string_view("\u207b"));
+                unsigned magnitude = exponent < 0 ? unsigned(-exponent) : unsigned(exponent);
+                unsigned divisor = 1;
+                while(magnitude / divisor >= 10)
+                    divisor *= 10;
+                for(; divisor > 0; divisor /= 10)
+                    put(superscripts[magnitude / divisor % 10]);
+            }
+
+            // between the terms of a product
+            constexpr void put_separator()
+            {
+                if(separate)
+                    put(std::string_view("\u00b7"));
+                separate = true;
+            }
+        };
+
+        template<typename T>
+        constexpr std::string_view symbol_or_name()
+        {
+            if constexpr(has_unit_symbol_v<T>)
+                return unit_symbol<T>::value;
+            else
+                return meta::type_name<T>();
+        }
+
+        template<typename... DimensionPowers>
+        constexpr void write_dimension_symbol(symbol_writer& writer, meta::typelist<DimensionPowers...>)
+        {
+            [[maybe_unused]] auto write = [&](auto power_type)
+            {
+                using DimensionPower = typename decltype(power_type)::type;
+                using Base = typename DimensionPower::Base;
+                writer.put_separator();
+                if constexpr(has_dimension_symbol_v<Base>)
+                    writer.put(dimension_symbol<Base>::value);
+                else
+                    writer.put(meta::type_name<Base>());
+                writer.put_exponent(DimensionPower::exponent);
+            };
+            (write(meta::type<DimensionPowers>), ...);
+        }
+
+        // Coherent units of the base dimensions, eg m·s⁻²
+        template<typename... DimensionPowers>
+        constexpr void write_base_units_symbol(symbol_writer& writer, meta::typelist<DimensionPowers...>)
+        {
+            [[maybe_unused]] auto write = [&](auto power_type)
+            {
+                using DimensionPower = typename decltype(power_type)::type;
+                using BaseUnit = meta::downcast<unit_raw<typename DimensionPower::Base, magnitude_raw<>>>;
+                writer.put_separator();
+                writer.put(symbol_or_name<BaseUnit>());
+                writer.put_exponent(DimensionPower::exponent);
+            };
+            (write(meta::type<DimensionPowers>), ...);
+        }
+
+        template<typename... FactorPowers>
+        constexpr void write_irrational_factors(symbol_writer& writer, const magnitude_raw<FactorPowers...>&)
+        {
+            [[maybe_unused]] auto write = [&](auto power_type)
+            {
+                using FactorPower = typename decltype(power_type)::type;
+                using Factor = typename FactorPower::Base;
+                if constexpr(!is_int_factor<Factor>)
+                {
+                    writer.put_separator();
+                    writer.put(symbol_or_name<Factor>());
+                    writer.put_exponent(FactorPower::exponent);
+                }
+            };
+            (write(meta::type<FactorPowers>), ...);
+        }
+
+        // Prime factors with their exponents, for magnitudes that don't fit in a fraction, eg 2⁷⁰·m
+        template<typename... FactorPowers>
+        constexpr void write_int_factors(symbol_writer& writer, const magnitude_raw<FactorPowers...>&)
+        {
+            [[maybe_unused]] auto write = [&](auto power_type)
+            {
+                using FactorPower = typename decltype(power_type)::type;
+                using Factor = typename FactorPower::Base;
+                if constexpr(is_int_factor<Factor>)
+                {
+                    writer.put_separator();
+                    writer.put(uint64_t(Factor::value));
+                    writer.put_exponent(FactorPower::exponent);
+                }
+            };
+            (write(meta::type<FactorPowers>), ...);
+        }
+
+        /**
+         * SI prefix of a power of ten, empty if there is none
+         */
+        constexpr std::string_view si_prefix(uint64_t num, uint64_t den)
+        {
+            struct prefix
+            {
+                uint64_t num;
+                uint64_t den;
+                std::string_view symbol;
+            };
+            constexpr prefix prefixes[] = {
+                {1000000000000000000u, 1, "E"}, {1000000000000000u, 1, "P"}, {1000000000000u, 1, "T"},
+                {1000000000u, 1, "G"}, {1000000u, 1, "M"}, {1000u, 1, "k"}, {100u, 1, "h"}, {10u, 1, "da"},
+                {1, 10u, "d"}, {1, 100u, "c"}, {1, 1000u, "m"}, {1, 1000000u, "\u00b5"}, {1, 1000000000u, "n"},
+                {1, 1000000000000u, "p"}, {1, 1000000000000000u, "f"}, {1, 1000000000000000000u, "a"}};
+            for(const auto& p : prefixes)
+                if(p.num == num && p.den == den)
+                    return p.symbol;
+            return {};
+        }
+
+        template<typename Magnitude, typename... DimensionPowers>
+        constexpr void write_scaled_unit_symbol(symbol_writer& writer, meta::typelist<DimensionPowers...> dimension_list)
+        {
+            constexpr magnitude_ratio_t ratio = magnitude_ratio<Magnitude>;
+            constexpr std::string_view prefix = ratio.is_rational && ratio.fits
+                ? si_prefix(ratio.num, ratio.den) : std::string_view();
+
+            // single base dimension raised to 1 with a SI prefix, eg km
+            if constexpr(!prefix.empty() && sizeof...(DimensionPowers) == 1 && (0 + ... + DimensionPowers::exponent) == 1)
+                writer.put(prefix);
+            else
+            {
+                // otherwise the magnitude is written as a factor, eg 3600·s,
+                // or as its prime factors when the fraction doesn't fit in 64 bits
+                if constexpr(!ratio.fits)
+                    write_int_factors(writer, Magnitude{});
+                else if constexpr(ratio.num != 1 || ratio.den != 1)
+                {
+                    writer.put(ratio.num);
+                    if(ratio.den != 1)
+                    {
+                        writer.put('/');
+                        writer.put(ratio.den);
+                    }
+                    writer.separate = true;
+                }
+                write_irrational_factors(writer, Magnitude{});
+            }
+            write_base_units_symbol(writer, dimension_list);
+        }
+
+        template<typename Unit>
+        constexpr void write_unit_symbol(symbol_writer& writer)
+        {
+            if constexpr(has_unit_symbol_v<Unit>)
+                writer.put(unit_symbol<Unit>::value);
+            else
+                write_scaled_unit_symbol<typename Unit::Magnitude>(writer, Unit::Dimension::typelist());
+        }
+
+        template<typename Unit>
+        struct unit_symbol_storage
+        {
+            static constexpr size_t size()
+            {
+                symbol_writer writer;
+                write_unit_symbol<Unit>(writer);
+                return writer.size;
+            }
+
+            static constexpr std::array<char, size() + 1> make()
+            {
+                std::array<char, size() + 1> text = {};
+                symbol_writer writer{text.data()};
+                write_unit_symbol<Unit>(writer);
+                return text;
+            }
+
+            static constexpr std::array<char, size() + 1> value = make();
+        };
+
+        template<typename Dimension>
+        struct dimension_symbol_storage
+        {
+            static constexpr void write(symbol_writer& writer)
+            {
+                if constexpr(has_dimension_symbol_v<Dimension>)
+                    writer.put(dimension_symbol<Dimension>::value);
+                else
+                    write_dimension_symbol(writer, Dimension::typelist());
+            }
+
+            static constexpr size_t size()
+            {
+                symbol_writer writer;
+                write(writer);
+                return writer.size;
+            }
+
+            static constexpr std::array<char, size() + 1> make()
+            {
+                std::array<char, size() + 1> text = {};
+                symbol_writer writer{text.data()};
+                write(writer);
+                return text;
+            }
+
+            static constexpr std::array<char, size() + 1> value = make();
+        };
+    }
+
+    /**
+     * Symbol of any unit, built at compile time and stored in a null terminated static array.
+     * It is the symbol of the unit if it has one (see unit_symbol), otherwise it is made from
+     * the magnitude and the coherent units of the base dimensions, eg "km" or "m·s⁻²".
+     */
+    template<typename Unit>
+    inline constexpr std::string_view unit_symbol_of{detail::unit_symbol_storage<Unit>::value.data(),
+                                                     detail::unit_symbol_storage<Unit>::value.size() - 1};
+
+    /**
+     * Symbol of any dimension, built like unit_symbol_of from the symbols of the
+     * base dimensions, eg "L·T⁻²"
+     */
+    template<typename Dimension>
+    inline constexpr std::string_view dimension_symbol_of{detail::dimension_symbol_storage<Dimension>::value.data(),
+                                                          detail::dimension_symbol_storage<Dimension>::value.size() - 1};
+}
+
+#endif // SYMBOL_HPP
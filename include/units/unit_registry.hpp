@@ -0,0 +1,198 @@
+#ifndef UNIT_REGISTRY_HPP
+#define UNIT_REGISTRY_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include "convert.hpp"
+
+
+namespace units
+{
+    namespace detail
+    {
+        /**
+         * Whether ApplyMagnitudeAsRational can apply Magnitude to integers of type T
+         */
+        template<typename Magnitude, typename T>
+        constexpr bool is_exact_magnitude()
+        {
+            constexpr auto ratio = magnitude_ratio<Magnitude>;
+            using Wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+            constexpr auto wide_max = static_cast<uint64_t>(std::numeric_limits<Wide>::max());
+            if constexpr(!ratio.is_rational || !ratio.fits || ratio.num > wide_max || ratio.den > wide_max)
+                return false;
+            #ifndef __SIZEOF_INT128__
+            else if constexpr(ratio.num != 1 && ratio.den != 1 && ratio.den - 1 > wide_max / ratio.num)
+                return false;
+            #endif
+            else
+                return true;
+        }
+
+        /**
+         * Apply Magnitude to n integers, exactly if it is rational (see ApplyMagnitudeAsRational),
+         * with a double factor otherwise
+         */
+        template<typename Magnitude, typename T>
+        constexpr void apply_to_integers(const T* in, T* out, size_t n)
+        {
+            for(size_t i = 0; i < n; ++i)
+            {
+                if constexpr(is_exact_magnitude<Magnitude, T>())
+                    out[i] = T(ApplyMagnitudeAsRational::apply<Magnitude>(in[i]));
+                else
+                    out[i] = T(magnitude_factor<Magnitude, double> * double(in[i]));
+            }
+        }
+    }
+
+    /**
+     * A set of units known at compile time, referred to by their index at runtime,
+     * eg a unit code read from a protocol or picked in a user interface.
+     * The factor between every pair of units is computed at compile time, so that a
+     * conversion is a lookup in a table and a multiplication. Integers are converted
+     * exactly instead, with a table of the conversion functions of every pair of units.
+     * Units of different dimensions can be registered together, but only units of the
+     * same dimension can be converted to each other: indices that are out of range or
+     * refer to units of different dimensions make the conversion fail.
+     * `using length_units = units::unit_registry<metre, kilometre, mile>;`
+     * `std::optional<double> metres = length_units::convert(value, code, length_units::index_of<metre>);`
+     */
+    template<typename... Units>
+    class unit_registry
+    {
+        static_assert(sizeof...(Units) > 0, "A unit registry needs at least one unit");
+        static_assert((detail::is_unit<Units> && ...), "Only units can be registered");
+
+        static constexpr size_t unit_count = sizeof...(Units);
+
+        template<typename From, typename To, typename Factor>
+        static constexpr Factor factor()
+        {
+            if constexpr(std::is_same_v<typename From::Dimension, typename To::Dimension>)
+                return detail::magnitude_factor<
+                    MultiplyMagnitude<typename From::Magnitude, InverseMagnitude<typename To::Magnitude>>, Factor>;
+            else
+                return Factor(0);
+        }
+
+        template<typename From, typename Factor>
+        static constexpr std::array<Factor, unit_count> factor_row() { return {factor<From, Units, Factor>()...}; }
+
+        template<typename T>
+        using integer_converter = void (*)(const T*, T*, size_t);
+
+        template<typename From, typename To, typename T>
+        static constexpr integer_converter<T> converter()
+        {
+            if constexpr(std::is_same_v<typename From::Dimension, typename To::Dimension>)
+                return &detail::apply_to_integers<
+                    MultiplyMagnitude<typename From::Magnitude, InverseMagnitude<typename To::Magnitude>>, T>;
+            else
+                return nullptr;
+        }
+
+        template<typename From, typename T>
+        static constexpr std::array<integer_converter<T>, unit_count> converter_row()
+        {
+            return {converter<From, Units, T>()...};
+        }
+
+        template<typename T>
+        static constexpr std::array<std::array<integer_converter<T>, unit_count>, unit_count> integer_converters =
+            {converter_row<Units, T>()...};
+
+        template<typename From>
+        static constexpr std::array<bool, unit_count> compatible_row()
+        {
+            return {std::is_same_v<typename From::Dimension, typename Units::Dimension>...};
+        }
+
+        template<typename Unit, size_t... I>
+        static constexpr size_t index_of_impl(std::index_sequence<I...>)
+        {
+            static_assert((std::is_same_v<Unit, Units> || ...), "The unit is not registered");
+            size_t index = unit_count;
+            ((index = std::is_same_v<Unit, Units> && index == unit_count ? I : index), ...);
+            return index;
+        }
+
+    public:
+        static constexpr size_t size() { return unit_count; }
+
+        /**
+         * Index of a registered unit
+         */
+        template<typename Unit>
+        static constexpr size_t index_of = index_of_impl<Unit>(std::index_sequence_for<Units...>{});
+
+        /**
+         * Table of the factors from each unit (row) to each unit (column), in the type Factor.
+         * Factors between units of different dimensions are 0.
+         */
+        template<typename Factor>
+        static constexpr std::array<std::array<Factor, unit_count>, unit_count> factors = {factor_row<Units, Factor>()...};
+
+        static constexpr std::array<std::array<bool, unit_count>, unit_count> compatibility = {compatible_row<Units>()...};
+
+        /**
+         * Whether both indices are registered units of the same dimension
+         */
+        static constexpr bool compatible(size_t from, size_t to)
+        {
+            return from < unit_count && to < unit_count && compatibility[from][to];
+        }
+
+        /**
+         * Convert a value from the unit at index from to the unit at index to,
+         * nothing is returned if they are not compatible
+         */
+        template<typename T>
+        static constexpr std::optional<T> convert(const T& value, size_t from, size_t to)
+        {
+            using AccumulationType = decltype(std::declval<T>() * std::declval<float>());
+            if(!compatible(from, to))
+                return std::nullopt;
+            if(from == to)
+                return value;
+            if constexpr(std::is_integral_v<T>)
+            {
+                T result{};
+                integer_converters<T>[from][to](&value, &result, 1);
+                return result;
+            }
+            else
+                return T(factors<AccumulationType>[from][to] * AccumulationType(value));
+        }
+
+        /**
+         * Convert n values from the unit at index from to the unit at index to,
+         * in and out can be the same buffer.
+         * Returns false without writing anything if the units are not compatible.
+         */
+        template<typename T>
+        static bool convert(const T* in, T* out, size_t n, size_t from, size_t to)
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be converted in batch");
+            using AccumulationType = decltype(std::declval<T>() * std::declval<float>());
+            if(!compatible(from, to))
+                return false;
+            if(from == to)
+            {
+                if(in != out && n > 0)
+                    std::memmove(out, in, n * sizeof(T));
+            }
+            else if constexpr(std::is_integral_v<T>)
+                integer_converters<T>[from][to](in, out, n);
+            else
+                detail::simd::scale(in, out, n, factors<AccumulationType>[from][to]);
+            return true;
+        }
+    };
+}
+
+#endif // UNIT_REGISTRY_HPP
@@ -0,0 +1,161 @@
+#ifndef VIEWS_HPP
+#define VIEWS_HPP
+
+#include "quantity.hpp"
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#include <span>
+#endif
+
+
+// The range adaptors need the C++20 ranges library, nothing is defined without it
+#if defined(__cpp_lib_ranges)
+
+namespace units::views
+{
+    namespace detail
+    {
+        template<typename Range>
+        using range_quantity = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+
+        // quantity_span and quantity_vector give a const element_type for const views
+        template<typename Range>
+        using range_element = std::remove_reference_t<std::ranges::range_reference_t<Range>>;
+
+        // Contiguous ranges that can be reinterpreted as a span without dangling
+        template<typename Range>
+        inline constexpr bool is_reinterpretable_range =
+            std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range> &&
+            std::ranges::borrowed_range<Range> &&
+            units::detail::is_quantity<range_quantity<Range>> &&
+            units::detail::is_layout_compatible_quantity<range_quantity<Range>>;
+
+        // Quantity with the value type and the policy of Quantity, in the unit To
+        template<typename To, typename Quantity>
+        struct converted_quantity;
+
+        template<typename To, typename Unit, typename T, typename ApplyMagnitudePolicy>
+        struct converted_quantity<To, quantity<Unit, T, ApplyMagnitudePolicy>>
+        {
+            using type = quantity<To, T, ApplyMagnitudePolicy>;
+        };
+
+        template<typename To>
+        struct convert_to
+        {
+            template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+            constexpr quantity<To, T, ApplyMagnitudePolicy> operator()(
+                const quantity<Unit, T, ApplyMagnitudePolicy>& q) const
+            {
+                return q.as(To{});
+            }
+        };
+
+        struct raw_value
+        {
+            template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+            constexpr T& operator()(quantity<Unit, T, ApplyMagnitudePolicy>& q) const
+            {
+                return units::detail::quantity_maker::value(q);
+            }
+
+            template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+            constexpr const T& operator()(const quantity<Unit, T, ApplyMagnitudePolicy>& q) const
+            {
+                return units::detail::quantity_maker::value(q);
+            }
+
+            // quantities made on the fly, eg by as, give their value by copy
+            template<typename Unit, typename T, typename ApplyMagnitudePolicy>
+            constexpr T operator()(quantity<Unit, T, ApplyMagnitudePolicy>&& q) const
+            {
+                return units::detail::quantity_maker::value(q);
+            }
+        };
+
+        template<typename To>
+        struct as_adaptor
+        {
+            template<std::ranges::viewable_range Range>
+            constexpr auto operator()(Range&& range) const
+            {
+                using Quantity = range_quantity<Range>;
+                static_assert(units::detail::is_quantity<Quantity>, "Only ranges of quantities can be converted");
+                using Magnitude = MultiplyMagnitude<typename Quantity::unit::Magnitude,
+                                                    InverseMagnitude<typename To::Magnitude>>;
+
+                // same magnitude: the quantities are only seen with another unit
+                if constexpr(units::detail::is_identity_magnitude<Magnitude> && is_reinterpretable_range<Range>)
+                {
+                    using Element = range_element<Range>;
+                    using Converted = typename converted_quantity<To, Quantity>::type;
+                    using ConvertedElement = std::conditional_t<std::is_const_v<Element>, const Converted, Converted>;
+                    static_assert(std::is_same_v<typename Quantity::unit::Dimension, typename To::Dimension>,
+                                  "Cannot convert between units of different dimensions");
+                    return std::span<ConvertedElement>(reinterpret_cast<ConvertedElement*>(std::ranges::data(range)),
+                                                       std::ranges::size(range));
+                }
+                else
+                    return std::views::transform(std::forward<Range>(range), convert_to<To>{});
+            }
+
+            template<std::ranges::viewable_range Range>
+            friend constexpr auto operator|(Range&& range, const as_adaptor& adaptor)
+            {
+                return adaptor(std::forward<Range>(range));
+            }
+        };
+
+        struct raw_adaptor
+        {
+            template<std::ranges::viewable_range Range>
+            constexpr auto operator()(Range&& range) const
+            {
+                using Quantity = range_quantity<Range>;
+                static_assert(units::detail::is_quantity<Quantity>, "Only ranges of quantities can be unwrapped");
+
+                if constexpr(is_reinterpretable_range<Range>)
+                {
+                    using Element = range_element<Range>;
+                    using Value = std::conditional_t<std::is_const_v<Element>,
+                                                     const typename Quantity::value_type, typename Quantity::value_type>;
+                    return std::span<Value>(reinterpret_cast<Value*>(std::ranges::data(range)),
+                                            std::ranges::size(range));
+                }
+                else
+                    return std::views::transform(std::forward<Range>(range), raw_value{});
+            }
+
+            template<std::ranges::viewable_range Range>
+            friend constexpr auto operator|(Range&& range, const raw_adaptor& adaptor)
+            {
+                return adaptor(std::forward<Range>(range));
+            }
+        };
+    }
+
+    /**
+     * Range adaptor converting quantities to Unit as they are read,
+     * with the factor of the conversion computed at compile time.
+     * `for(auto d : distances | std::views::filter(is_valid) | units::views::as<kilometre>)`
+     * The result is a sized and random access range when the input is, and when Unit has
+     * the magnitude of the input it is a span over the same memory.
+     */
+    template<typename Unit>
+    inline constexpr detail::as_adaptor<Unit> as{};
+
+    /**
+     * Range adaptor giving the raw values of quantities, writable if the quantities are.
+     * Contiguous ranges give a span over the same memory, so that they can be given
+     * to code expecting plain numbers.
+     */
+    inline constexpr detail::raw_adaptor raw{};
+}
+
+#endif
+
+#endif // VIEWS_HPP
@@ -0,0 +1,76 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/accumulator.hpp>
+#include <units/quantity_span.hpp>
+#include <cstdint>
+#include <vector>
+
+
+TEST_CASE("accumulator sums in a wider type", "[accumulator]")
+{
+    std::vector<units::quantity<metre, float>> distances(1000003, 0.1f * m);
+
+    units::quantity<metre, float> naive = 0.f * m;
+    for(const auto& distance : distances)
+        naive += distance;
+
+    units::quantity_accumulator<metre, float> total;
+    STATIC_REQUIRE(std::is_same_v<decltype(total)::accumulation_type, double>);
+    total.add(distances);
+    CHECK(total.count() == distances.size());
+    const double exact = double(0.1f) * double(distances.size());
+    CHECK(total.value() == Approx(exact).epsilon(1e-12));
+    CHECK(total.total() == float(exact) * m);
+    CHECK(naive != float(exact) * m);
+}
+
+
+TEST_CASE("accumulator compensation", "[accumulator]")
+{
+    const std::vector<units::quantity<metre>> distances = {1. * m, 1e100 * m, 1. * m, -1e100 * m};
+
+    units::quantity_accumulator<metre> wide;
+    for(const auto& distance : distances)
+        wide += distance;
+    CHECK(wide.value() == 0);
+
+    units::quantity_accumulator<metre, double, units::AccumulateCompensated<>> compensated;
+    compensated.add(distances);
+    CHECK(compensated.value() == 2);
+
+    units::quantity_accumulator<metre, double, units::AccumulateCompensated<>> one_by_one;
+    for(const auto& distance : distances)
+        one_by_one += distance;
+    CHECK(one_by_one.value() == 2);
+}
+
+
+TEST_CASE("accumulator converts units", "[accumulator]")
+{
+    units::quantity_accumulator<metre, float> total;
+    total += 1.5f * km;
+    total += 250.f * mm;
+    CHECK(total.total() == 1500.25f * m);
+
+    std::vector<float> kilometres(21, 2.f);
+    total.add(units::quantity_span<kilometre, const float>(kilometres.data(), kilometres.size()));
+    CHECK(total.count() == 23);
+    CHECK(total.total() == 43500.25f * m);
+
+    units::quantity_accumulator<millimetre, int32_t> millimetres;
+    STATIC_REQUIRE(std::is_same_v<decltype(millimetres)::accumulation_type, int64_t>);
+    std::vector<units::quantity<metre, int32_t>> metres(10, int32_t(2000000) * m);
+    millimetres.add(metres);
+    CHECK(millimetres.value() == 20000000000);
+
+    units::quantity_accumulator<kilometre, float> kilometres_total;
+    kilometres_total.merge(total);
+    kilometres_total += 1.f * km;
+    CHECK(kilometres_total.count() == 24);
+    CHECK(kilometres_total.total() == 44.50025f * km);
+
+    kilometres_total.reset();
+    CHECK(kilometres_total.count() == 0);
+    CHECK(kilometres_total.value() == 0);
+}
@@ -0,0 +1,60 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/atomic_quantity.hpp>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("atomic quantity operations", "[atomic_quantity]")
+{
+    STATIC_REQUIRE(units::atomic_quantity<metre, int64_t>::is_always_lock_free ==
+                   std::atomic<int64_t>::is_always_lock_free);
+
+    units::atomic_quantity<metre> distance(2. * m);
+    CHECK(distance.is_lock_free() == std::atomic<double>().is_lock_free());
+    CHECK(distance.load() == 2. * m);
+
+    distance.store(1.5 * km);
+    CHECK(distance.load() == 1500. * m);
+    CHECK((distance = 20. * mm) == 0.02 * m);
+
+    CHECK(distance.exchange(3. * m) == 0.02 * m);
+    CHECK(distance.fetch_add(1. * km) == 3. * m);
+    CHECK(distance.fetch_sub(3. * m, std::memory_order_relaxed) == 1003. * m);
+    CHECK((distance += 500. * mm) == 1000.5 * m);
+    CHECK((distance -= 0.5 * m) == 1000. * m);
+
+    units::quantity<metre> expected = 1. * m;
+    CHECK_FALSE(distance.compare_exchange_strong(expected, 2. * km));
+    CHECK(expected == 1000. * m);
+    CHECK(distance.compare_exchange_strong(expected, 2. * km));
+    CHECK(units::quantity<metre>(distance) == 2000. * m);
+
+    while(!distance.compare_exchange_weak(expected, expected + 1. * m, std::memory_order_acq_rel,
+                                          std::memory_order_acquire))
+        ;
+    CHECK(distance.load() == 2001. * m);
+}
+
+
+TEST_CASE("atomic quantity shared between threads", "[atomic_quantity]")
+{
+    units::atomic_quantity<millisecond, int64_t> elapsed;
+    units::atomic_quantity<metre> travelled;
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 4; ++thread)
+        threads.emplace_back([&]
+        {
+            for(int i = 0; i < 10000; ++i)
+            {
+                elapsed.fetch_add(int64_t(1) * s, std::memory_order_relaxed);
+                travelled += 0.5 * m;
+            }
+        });
+    for(auto& thread : threads)
+        thread.join();
+    CHECK(elapsed.load() == int64_t(40000000) * ms);
+    CHECK(travelled.load() == 20000. * m);
+}
@@ -0,0 +1,83 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/chrono.hpp>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace
+{
+    struct Duration : units::BaseDimension<Duration>
+    {};
+    struct TimeSquared : units::CombinedDimension<TimeSquared, units::Power<Time, 2>>
+    {};
+    struct second_squared : units::BaseUnit<second_squared, TimeSquared>
+    {};
+}
+
+template<>
+struct units::is_time_dimension<Duration> : std::true_type {};
+
+
+TEST_CASE("time dimensions", "[chrono]")
+{
+    STATIC_REQUIRE(units::is_time_dimension_v<Time>);
+    STATIC_REQUIRE(units::is_time_dimension_v<Duration>);
+    STATIC_REQUIRE_FALSE(units::is_time_dimension_v<Length>);
+    STATIC_REQUIRE_FALSE(units::is_time_dimension_v<Speed>);
+
+    // only units of a time dimension can be converted from and to durations
+    STATIC_REQUIRE(units::detail::is_time_unit<millisecond>);
+    STATIC_REQUIRE_FALSE(units::detail::is_time_unit<kilometre>);
+    STATIC_REQUIRE_FALSE(units::detail::is_time_unit<metre_per_second>);
+    STATIC_REQUIRE_FALSE(units::detail::is_time_unit<second_squared>);
+}
+
+
+TEST_CASE("from_duration", "[chrono]")
+{
+    using namespace std::chrono;
+
+    // same period, the count is only copied
+    constexpr auto elapsed = units::from_duration<millisecond>(milliseconds(1234));
+    STATIC_REQUIRE(std::is_same_v<decltype(elapsed), const units::quantity<millisecond, milliseconds::rep>>);
+    STATIC_REQUIRE(elapsed == int64_t(1234) * ms);
+    STATIC_REQUIRE(units::from_duration<second>(duration<double>(2.5)) == 2.5 * s);
+
+    // integers are converted exactly
+    STATIC_REQUIRE(units::from_duration<millisecond>(minutes(3)).in(ms) == 180000);
+    STATIC_REQUIRE(units::from_duration<second>(milliseconds(2999)).in(s) == 2);
+    STATIC_REQUIRE(units::from_duration<second>(milliseconds(-2999)).in(s) == -2);
+    STATIC_REQUIRE(units::from_duration<minute>(nanoseconds(INT64_MAX)).in(minute{}) ==
+                   duration_cast<minutes>(nanoseconds(INT64_MAX)).count());
+
+    CHECK(units::from_duration<second>(duration<double, std::milli>(1500)).in(s) == Approx(1.5));
+    CHECK(units::from_duration<millisecond>(duration<float>(0.25f)).in(ms) == Approx(250));
+}
+
+
+TEST_CASE("to_duration", "[chrono]")
+{
+    using namespace std::chrono;
+
+    STATIC_REQUIRE(units::to_duration<milliseconds>(int64_t(42) * ms) == milliseconds(42));
+    STATIC_REQUIRE(units::to_duration<milliseconds>(int64_t(2) * units::quantity<minute, int64_t>::unit{}) ==
+                   milliseconds(120000));
+    STATIC_REQUIRE(units::to_duration<seconds>(int64_t(1999) * ms) == seconds(1));
+    STATIC_REQUIRE(units::to_duration<seconds>(int64_t(-1999) * ms) == seconds(-1));
+    CHECK(units::to_duration<duration<double>>(int64_t(1500) * ms).count() == Approx(1.5));
+    CHECK(units::to_duration<milliseconds>(1.5 * s) == milliseconds(1500));
+
+    // the period is deduced from the unit
+    constexpr auto period = units::to_duration(int32_t(5) * units::quantity<minute, int32_t>::unit{});
+    STATIC_REQUIRE(std::is_same_v<decltype(period), const duration<int32_t, std::ratio<60>>>);
+    STATIC_REQUIRE(period == minutes(5));
+    STATIC_REQUIRE(std::is_same_v<decltype(units::to_duration(1. * ms)), duration<double, std::milli>>);
+
+    // round trip
+    const auto timeout = nanoseconds(123456789);
+    CHECK(units::to_duration<nanoseconds>(units::from_duration<second>(duration<double>(timeout))) == timeout);
+    CHECK(units::to_duration<nanoseconds>(units::from_duration<millisecond>(timeout)) == nanoseconds(123000000));
+}
@@ -0,0 +1,100 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/column_file.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+
+namespace
+{
+    std::string temporary_path(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+}
+
+
+TEST_CASE("column file round trip", "[column_file]")
+{
+    const std::string path = temporary_path("units_test_column_file.ucol");
+    std::vector<double> altitudes = {3, 1, 4, 1, 5, 9, 2};
+    std::vector<units::quantity<millisecond, int64_t>> durations;
+    for(int64_t i = 0; i < 7; ++i)
+        durations.push_back(i * 1500 * units::quantity<millisecond, int64_t>::unit{});
+
+    units::column_file_writer writer(3);
+    REQUIRE(writer.add_column<kilometre>("altitude", altitudes.data(), altitudes.size()) ==
+            units::column_file_error::none);
+    REQUIRE(writer.add_column("duration", durations.data(), durations.size()) == units::column_file_error::none);
+    REQUIRE(writer.write(path) == units::column_file_error::none);
+
+    SECTION("same unit is viewed in place")
+    {
+        units::column_file_reader<units::column<kilometre, double>> reader;
+        REQUIRE(reader.open(path, {"altitude"}) == units::column_file_error::none);
+        CHECK(reader.rows() == 7);
+
+        auto column = reader.get<0>();
+        CHECK(column.block_count() == 3);
+        auto values = column.values();
+        REQUIRE(values.size() == 7);
+        CHECK(values[5].in(m) == 9000);
+        CHECK(column.block(2).size() == 1);
+        CHECK(column.block(1).data() == values.data() + 3);
+        CHECK(column.block_min(0).in(km) == 1);
+        CHECK(column.block_max(1).in(km) == 9);
+    }
+
+    SECTION("other unit is converted by block")
+    {
+        units::column_file_reader<units::column<metre, double, kilometre>,
+                                  units::column<second, int64_t, millisecond>> reader;
+        REQUIRE(reader.open(path, {"altitude", "duration"}) == units::column_file_error::none);
+
+        auto altitude = reader.get<0>();
+        CHECK(altitude.block(1)[2].in(m) == 9000);
+        CHECK(altitude.block_max(0).in(m) == 4000);
+
+        auto duration = reader.get<1>();
+        auto block = duration.block(1);
+        REQUIRE(block.size() == 3);
+        CHECK(block[0].in(s) == 4);
+        CHECK(block[2].in(s) == 7);
+        CHECK(duration.block_min(2).in(s) == 9);
+    }
+
+    SECTION("mismatches are rejected on open")
+    {
+        units::column_file_reader<units::column<kilometre, double>> missing;
+        CHECK(missing.open(path, {"speed"}) == units::column_file_error::missing_column);
+
+        units::column_file_reader<units::column<kilometre, float>> wrong_type;
+        CHECK(wrong_type.open(path, {"altitude"}) == units::column_file_error::element_type_mismatch);
+
+        units::column_file_reader<units::column<second, double>> wrong_dimension;
+        CHECK(wrong_dimension.open(path, {"altitude"}) == units::column_file_error::dimension_mismatch);
+
+        units::column_file_reader<units::column<kilometre, double, metre>> wrong_magnitude;
+        CHECK(wrong_magnitude.open(path, {"altitude"}) == units::column_file_error::magnitude_mismatch);
+
+        units::column_file_reader<units::column<kilometre, double>> not_a_file;
+        CHECK(not_a_file.open(path + ".missing", {"altitude"}) == units::column_file_error::io_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE("column file writer rejects invalid columns", "[column_file]")
+{
+    std::vector<double> values = {1, 2, 3};
+    units::column_file_writer writer;
+    CHECK(writer.add_column<metre>(std::string(48, 'x'), values.data(), values.size()) ==
+          units::column_file_error::name_too_long);
+    CHECK(writer.add_column<metre>(std::string(47, 'x'), values.data(), values.size()) ==
+          units::column_file_error::none);
+    CHECK(writer.add_column<second>("short", values.data(), 2) == units::column_file_error::row_count_mismatch);
+    CHECK(writer.add_column<second>("same", values.data(), 3) == units::column_file_error::none);
+}
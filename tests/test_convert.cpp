@@ -0,0 +1,69 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/convert.hpp>
+#include <vector>
+
+
+namespace
+{
+    struct kibimetre : units::ScaledUnit<kibimetre, metre, units::MagnitudeFromInt<1024>>
+    {};
+
+    template<typename From, typename To, typename T>
+    void check_convert(size_t size)
+    {
+        std::vector<units::quantity<From, T>> in;
+        for(size_t i = 0; i < size; ++i)
+            in.push_back(T(i * 7 + 3) * From{});
+
+        std::vector<units::quantity<To, T>> out(size, T(0) * To{});
+        units::convert(in, out);
+        for(size_t i = 0; i < size; ++i)
+            CHECK(out[i].in(To{}) == in[i].in(To{}));
+
+        auto converted = units::convert_in_place<To>(in.data(), in.size());
+        for(size_t i = 0; i < size; ++i)
+            CHECK(converted[i] == out[i]);
+    }
+}
+
+
+TEST_CASE("Batch conversion gives the same results as in()", "[convert]")
+{
+    // sizes that exercise the vector bodies and the scalar tails
+    for(size_t size : {0, 1, 3, 8, 17, 33, 100})
+    {
+        check_convert<kilometre, metre, float>(size);
+        check_convert<metre, kilometre, double>(size);
+        check_convert<kilometre, millimetre, double>(size);
+        check_convert<second, minute, int32_t>(size);
+        check_convert<minute, second, int64_t>(size);
+        check_convert<metre, metre, double>(size);
+        check_convert<kibimetre, metre, int32_t>(size);
+        check_convert<metre, kibimetre, int64_t>(size);
+    }
+}
+
+
+TEST_CASE("Batch conversion of raw values", "[convert]")
+{
+    std::vector<int64_t> values = {1, 2, 3, 4, 5};
+    units::convert_values<kilometre, metre, units::ApplyMagnitudeAsRational>(values.data(), values.data(),
+                                                                              values.size());
+    CHECK(values == std::vector<int64_t>{1000, 2000, 3000, 4000, 5000});
+}
+
+
+TEST_CASE("Batch conversion between ranges of different sizes", "[convert]")
+{
+    std::vector<units::quantity<kilometre>> in(5, 1.0 * km);
+    std::vector<units::quantity<metre>> out(3, 0.0 * m);
+    CHECK(units::convert(in, out) == 3);
+    CHECK(out[2] == 1000.0 * m);
+
+    std::vector<units::quantity<metre>> longer(8, -1.0 * m);
+    CHECK(units::convert(in, longer) == 5);
+    CHECK(longer[4] == 1000.0 * m);
+    CHECK(longer[5] == -1.0 * m);
+}
@@ -0,0 +1,103 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/dyn_quantity.hpp>
+
+
+TEST_CASE("dyn_dimension packs exponents", "[dyn_quantity]")
+{
+    constexpr auto length = units::dyn_dimension_of<Length>;
+    constexpr auto time = units::dyn_dimension_of<Time>;
+    constexpr auto speed = units::dyn_dimension_of<Speed>;
+
+    STATIC_REQUIRE(length.exponent(0) == 1);
+    STATIC_REQUIRE(speed.exponent(0) == 1);
+    STATIC_REQUIRE(speed.exponent(1) == -1);
+    STATIC_REQUIRE(length / time == speed);
+    STATIC_REQUIRE(speed * time == length);
+    STATIC_REQUIRE((speed / time / time).exponent(1) == -3);
+    STATIC_REQUIRE((length / length).is_scalar());
+    STATIC_REQUIRE((units::dyn_dimension() / time / time * time).exponent(1) == -1);
+
+    auto wide = units::dyn_dimension().with_exponent(7, -60).with_exponent(3, 60);
+    CHECK((wide * wide / wide) == wide);
+    CHECK((wide * wide).exponent(7) == -120);
+    CHECK((wide / wide).is_scalar());
+}
+
+
+TEST_CASE("dyn_dimension reports exponents out of range", "[dyn_quantity]")
+{
+    const auto wide = units::dyn_dimension().with_exponent(7, -100).with_exponent(3, 100);
+    const auto one = units::dyn_dimension().with_exponent(3, 1);
+    CHECK_FALSE(checked_multiply(wide, wide));
+    CHECK_FALSE(checked_divide(wide, units::dyn_dimension() / wide));
+    CHECK(checked_divide(wide, wide) == units::dyn_dimension());
+
+    const auto highest = units::dyn_dimension().with_exponent(3, 127);
+    const auto lowest = units::dyn_dimension().with_exponent(3, -128);
+    CHECK_FALSE(checked_multiply(highest, one));
+    CHECK_FALSE(checked_divide(lowest, one));
+    CHECK(checked_multiply(lowest, highest) == units::dyn_dimension().with_exponent(3, -1));
+    CHECK(checked_divide(highest, one)->exponent(3) == 126);
+    CHECK(checked_divide(lowest, units::dyn_dimension().with_exponent(3, -1))->exponent(3) == -127);
+    CHECK_FALSE(checked_divide(units::dyn_dimension(), lowest));
+    // every lane is checked, not only the first one
+    CHECK_FALSE(checked_multiply(highest.with_exponent(0, 1), one.with_exponent(0, 1)));
+
+    const auto big = units::dyn_quantity<>(2.0, highest);
+    CHECK_FALSE(checked_multiply(big, units::dyn_quantity<>(3.0, one)));
+    CHECK(checked_multiply(big, units::dyn_quantity<>(1.0 * m / s))->dimension().exponent(3) == 127);
+    CHECK(checked_divide(big, units::dyn_quantity<>(2.0, one))->value() == 1);
+}
+
+
+TEST_CASE("dyn_quantity arithmetic", "[dyn_quantity]")
+{
+    units::dyn_quantity<> distance = 1.5 * km;
+    units::dyn_quantity<> duration = 30.0 * s;
+    CHECK(distance.dimension() == units::dyn_dimension_of<Length>);
+    CHECK(distance.scale() == 1000);
+
+    auto sum = distance + units::dyn_quantity<>(500.0 * m);
+    CHECK(sum.value() == 2);
+    CHECK(sum > distance);
+    CHECK(distance == units::dyn_quantity<>(1500.0 * m));
+
+    auto speed = distance / duration;
+    CHECK(speed.dimension() == units::dyn_dimension_of<Speed>);
+    CHECK(speed.in<metre_per_second>() == Approx(50));
+    CHECK_FALSE(same_dimension(speed, distance));
+}
+
+
+TEST_CASE("dyn_quantity reports mixed dimensions", "[dyn_quantity]")
+{
+    const units::dyn_quantity<> distance = 1.5 * km;
+    const units::dyn_quantity<> duration = 30.0 * s;
+
+    CHECK_FALSE(checked_add(distance, duration));
+    CHECK_FALSE(checked_subtract(distance, duration));
+    CHECK_FALSE(compare(distance, duration));
+
+    const auto sum = checked_add(distance, units::dyn_quantity<>(500.0 * m));
+    REQUIRE(sum);
+    CHECK(sum->value() == 2);
+    CHECK(checked_subtract(distance, units::dyn_quantity<>(500.0 * m))->value() == 1);
+    CHECK(compare(distance, units::dyn_quantity<>(1500.0 * m)) == 0);
+    CHECK(*compare(distance, units::dyn_quantity<>(2.0 * km)) < 0);
+    CHECK(*compare(distance, units::dyn_quantity<>(20.0 * m)) > 0);
+}
+
+
+TEST_CASE("dyn_quantity conversion to static quantity", "[dyn_quantity]")
+{
+    units::dyn_quantity<int> distance = 3 * units::quantity<kilometre, int>::unit{};
+
+    auto metres = distance.as<metre>();
+    REQUIRE(metres);
+    CHECK(metres->in(m) == 3000);
+    CHECK(distance.in(km) == 3);
+    CHECK_FALSE(distance.as<second>());
+    CHECK_FALSE(distance.in(s));
+}
@@ -0,0 +1,55 @@
+#include "unit_definition.h"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <units/expression.hpp>
+
+
+TEST_CASE("Lazy expressions compute the same values as quantities", "[expression]")
+{
+    units::quantity<metre_per_second> speed = 2.0 * m / s;
+
+    units::quantity<metre> distance = units::lazy(speed) * 10 * s;
+    CHECK(distance == 20 * m);
+
+    units::quantity<metre> distance2 = units::lazy(speed) * (10.0 * s);
+    CHECK(distance2 == 20 * m);
+
+    auto expression = units::lazy(3.0 * km) / (1.5 * ms);
+    CHECK(std::is_same_v<decltype(expression)::dimension, Speed>);
+    CHECK(expression.in<metre_per_second>() == Approx(2e6));
+
+    units::quantity<metre_per_second> converted = expression;
+    CHECK(converted.in<metre_per_second>() == Approx(2e6));
+}
+
+
+TEST_CASE("Lazy expressions apply one magnitude", "[expression]")
+{
+    // the km and mm factors cancel, no factor is applied
+    auto expression = units::lazy(2.0 * km) * (3.0 * mm) / (6.0 * m);
+    CHECK(std::is_same_v<decltype(expression)::magnitude, units::detail::magnitude_raw<>>);
+    CHECK(std::is_same_v<decltype(expression)::unit, metre>);
+    CHECK(expression.raw_value() == 1.0);
+    CHECK(expression.in(m) == 1.0);
+
+    auto quantity = expression.eval();
+    CHECK(std::is_same_v<decltype(quantity), units::quantity<metre>>);
+
+    // dimensionless result
+    auto ratio = units::lazy(1.0 * km) / (1.0 * m);
+    CHECK(ratio.in<units::ScalarUnit>() == 1000);
+    CHECK((2.0 / units::lazy(4.0 * s)).in(units::detail::inverse_unit<second>{}) == 0.5);
+}
+
+
+TEST_CASE("Lazy expressions into arrays", "[expression]")
+{
+    const std::array<double, 3> durations = {1, 2, 4};
+    std::array<units::quantity<metre>, 3> distances = {0.0 * m, 0.0 * m, 0.0 * m};
+    for(size_t i = 0; i < durations.size(); ++i)
+        distances[i] = units::lazy(0.5 * km) / s * (durations[i] * ms);
+    CHECK(distances[0].in(m) == Approx(0.5));
+    CHECK(distances[1].in(m) == Approx(1));
+    CHECK(distances[2].in(m) == Approx(2));
+}
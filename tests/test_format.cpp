@@ -0,0 +1,50 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/format.hpp>
+#include <string>
+
+
+namespace
+{
+    struct hectometre : units::ScaledUnit<hectometre, metre, units::MagnitudeFromInt<100>> {};
+    struct turn : units::ScaledUnit<turn, units::ScalarUnit, units::MagnitudeFromIrrational<units::pi>> {};
+    struct huge_metre : units::ScaledUnit<huge_metre, metre, units::MultiplyMagnitude<
+        units::MagnitudeFromInt<(uint64_t(1) << 40) * 3>, units::MagnitudeFromInt<uint64_t(1) << 40>>> {};
+
+    template<typename Quantity>
+    std::string format(const Quantity& q)
+    {
+        char buffer[units::max_formatted_size<Quantity>];
+        return std::string(buffer, units::format_to(buffer, q));
+    }
+}
+
+
+TEST_CASE("unit and dimension symbols", "[format]")
+{
+    STATIC_REQUIRE(units::unit_symbol_of<kilometre> == "km");
+    STATIC_REQUIRE(units::unit_symbol_of<hectometre> == "hm");
+    STATIC_REQUIRE(units::unit_symbol_of<decltype(m / (s * s))> == "m·s⁻²");
+    STATIC_REQUIRE(units::unit_symbol_of<decltype(km / min)> == "50/3·m·s⁻¹");
+    STATIC_REQUIRE(units::unit_symbol_of<turn> == "π");
+    STATIC_REQUIRE(units::unit_symbol_of<huge_metre> == "2⁸⁰·3·m");
+    STATIC_REQUIRE(units::unit_symbol_of<units::ScalarUnit> == "");
+
+    STATIC_REQUIRE(units::dimension_symbol_of<Length> == "L");
+    STATIC_REQUIRE(units::dimension_symbol_of<Speed> == "L·T⁻¹");
+    STATIC_REQUIRE(units::unit_symbol_of<kilometre>.data()[2] == '\0');
+}
+
+
+TEST_CASE("format quantities", "[format]")
+{
+    CHECK(format(12.5 * km) == "12.5 km");
+    CHECK(format(-3 * ms) == "-3 ms");
+    CHECK(format(units::quantity<metre_per_second, float>(2.f * m / s)) == "2 m·s⁻¹");
+    CHECK(format(1.0 * units::ScalarUnit{}) == "1");
+
+    char small[4];
+    auto result = units::to_chars(small, small + sizeof(small), 12.5 * km);
+    CHECK(result.ec == std::errc::value_too_large);
+}
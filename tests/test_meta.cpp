@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+#include <units/meta.hpp>
+#include <units/power.hpp>
+
+
+template<int N>
+struct tag
+{
+    static constexpr int value = N;
+};
+
+struct TagComparator
+{
+    template<typename TagType1, typename TagType2>
+    constexpr auto operator()(const TagType1&, const TagType2&) const
+    {
+        constexpr auto val1 = TagType1::type::Base::value;
+        constexpr auto val2 = TagType2::type::Base::value;
+        if constexpr(val1 == val2)
+            return meta::val<meta::ordering::equivalent>;
+        else if constexpr(val1 < val2)
+            return meta::val<meta::ordering::less>;
+        else
+            return meta::val<meta::ordering::greater>;
+    }
+};
+
+// Same ordering, but exposing an ordering key
+struct TagKeyComparator
+{
+    using key_type = int;
+
+    template<typename TagType>
+    static constexpr key_type key(const TagType&)
+    {
+        return TagType::type::Base::value;
+    }
+
+    template<typename TagType1, typename TagType2>
+    constexpr auto operator()(const TagType1&, const TagType2&) const
+    {
+        return meta::val<meta::compare_keys(key(TagType1{}), key(TagType2{}))>;
+    }
+};
+
+template<int N, int E = 1>
+using tag_pow = units::Power<tag<N>, E>;
+
+
+TEST_CASE("Split typelist", "[meta]")
+{
+    using List = meta::typelist<tag<0>, tag<1>, tag<2>, tag<3>, tag<4>>;
+    auto[left, right] = meta::split(meta::val<2>, List{});
+    CHECK(std::is_same_v<decltype(left), meta::typelist<tag<0>, tag<1>>>);
+    CHECK(std::is_same_v<decltype(right), meta::typelist<tag<2>, tag<3>, tag<4>>>);
+
+    auto[all, none] = meta::split(meta::val<5>, List{});
+    CHECK(std::is_same_v<decltype(all), List>);
+    CHECK(std::is_same_v<decltype(none), meta::typelist<>>);
+
+    CHECK(meta::at<3>(List{}) == meta::type<tag<3>>);
+}
+
+
+TEST_CASE("Sort typelist", "[meta]")
+{
+    {
+        using List = meta::typelist<tag_pow<4>, tag_pow<1>, tag_pow<3>, tag_pow<0>, tag_pow<2>>;
+        using Expected = meta::typelist<tag_pow<0>, tag_pow<1>, tag_pow<2>, tag_pow<3>, tag_pow<4>>;
+        CHECK(std::is_same_v<decltype(meta::sort(List{}, TagComparator{})), Expected>);
+        CHECK(std::is_same_v<decltype(meta::sort(List{}, TagKeyComparator{})), Expected>);
+    }
+
+    {
+        // sort is stable
+        using List = meta::typelist<tag_pow<2, 1>, tag_pow<1>, tag_pow<2, 2>, tag_pow<0>, tag_pow<2, 3>>;
+        using Expected =
+            meta::typelist<tag_pow<0>, tag_pow<1>, tag_pow<2, 1>, tag_pow<2, 2>, tag_pow<2, 3>>;
+        CHECK(std::is_same_v<decltype(meta::sort(List{}, TagComparator{})), Expected>);
+        CHECK(std::is_same_v<decltype(meta::sort(List{}, TagKeyComparator{})), Expected>);
+    }
+
+    CHECK(std::is_same_v<decltype(meta::sort(meta::typelist<>{}, TagComparator{})),
+                         meta::typelist<>>);
+}
+
+
+TEST_CASE("Merge typelists", "[meta]")
+{
+    using List1 = meta::typelist<tag_pow<0>, tag_pow<2>, tag_pow<5>>;
+    using List2 = meta::typelist<tag_pow<1>, tag_pow<2, 2>, tag_pow<7>>;
+
+    {
+        using Expected = meta::typelist<tag_pow<0>, tag_pow<1>, tag_pow<2>, tag_pow<2, 2>,
+                                        tag_pow<5>, tag_pow<7>>;
+        CHECK(std::is_same_v<decltype(meta::merge(List1{}, List2{}, TagComparator{})), Expected>);
+        CHECK(std::is_same_v<decltype(meta::merge(List1{}, List2{}, TagKeyComparator{})), Expected>);
+    }
+
+    {
+        using Expected = meta::typelist<tag_pow<0>, tag_pow<1>, tag_pow<2, 3>, tag_pow<5>, tag_pow<7>>;
+        auto res = meta::merge_combine_filter(List1{}, List2{}, TagComparator{},
+                                              units::detail::PowerCombiner{});
+        CHECK(std::is_same_v<decltype(res), Expected>);
+        auto res_key = meta::merge_combine_filter(List1{}, List2{}, TagKeyComparator{},
+                                                  units::detail::PowerCombiner{});
+        CHECK(std::is_same_v<decltype(res_key), Expected>);
+    }
+
+    {
+        using Inverse = meta::typelist<tag_pow<1, -1>, tag_pow<2, -1>, tag_pow<5, -1>>;
+        using Expected = meta::typelist<tag_pow<0>, tag_pow<1, -1>>;
+        auto res = meta::merge_combine_filter(List1{}, Inverse{}, TagComparator{},
+                                              units::detail::PowerCombiner{});
+        CHECK(std::is_same_v<decltype(res), Expected>);
+    }
+
+    CHECK(std::is_same_v<decltype(meta::merge(meta::typelist<>{}, List1{}, TagComparator{})),
+                         List1>);
+}
+
+
+TEST_CASE("Reduce typelist", "[meta]")
+{
+    using List = meta::typelist<tag<1>, tag<2>, tag<3>, tag<4>>;
+    constexpr int sum = meta::reduce(10, List{}, [](int acc, auto tagType)
+    {
+        return acc * 10 + decltype(tagType)::type::value;
+    });
+    CHECK(sum == 101234);
+
+    auto reversed = meta::reduce(meta::typelist<>{}, List{}, [](auto acc, auto tagType)
+    {
+        return acc.prepend(tagType);
+    });
+    CHECK(std::is_same_v<decltype(reversed), meta::typelist<tag<4>, tag<3>, tag<2>, tag<1>>>);
+}
@@ -0,0 +1,96 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/parallel.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    std::vector<units::quantity<metre>> make_distances(size_t n)
+    {
+        std::vector<units::quantity<metre>> distances;
+        distances.reserve(n);
+        // values of very different magnitudes so that the order of the additions matters
+        for(size_t i = 0; i < n; ++i)
+            distances.push_back(double(i % 1000) * (i % 7 == 0 ? 1e-9 : 1.0) * (i % 3 == 0 ? 1e6 : 1.0) * m);
+        return distances;
+    }
+
+    bool bitwise_equal(double lhs, double rhs)
+    {
+        return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+    }
+}
+
+
+TEST_CASE("parallel reduce", "[parallel]")
+{
+    std::vector<units::quantity<metre, int64_t>> distances;
+    for(int64_t i = 1; i <= 100000; ++i)
+        distances.push_back(int64_t(i) * units::quantity<metre, int64_t>::unit{});
+
+    units::thread_pool pool(4);
+    const auto expected = int64_t(100000) * 100001 / 2;
+    CHECK(units::reduce(units::execution::seq, distances).in(m) == expected);
+    CHECK(units::reduce(units::execution::par, distances).in(m) == expected);
+    CHECK(units::reduce(units::execution::parallel_policy{&pool}, distances).in(m) == expected);
+    CHECK(units::reduce(units::execution::parallel_policy{&pool}, distances, int64_t(5) * units::quantity<metre, int64_t>::unit{}).in(m) ==
+          expected + 5);
+
+    std::vector<units::quantity<metre>> empty;
+    CHECK(units::reduce(units::execution::par, empty).in(m) == 0);
+}
+
+
+TEST_CASE("deterministic parallel reduce", "[parallel]")
+{
+    const auto distances = make_distances(1000003);
+    units::thread_pool pool(4);
+
+    const double sequential = units::reduce(units::execution::seq, distances).in(m);
+    for(size_t threads = 1; threads <= 4; ++threads)
+    {
+        units::execution::parallel_policy policy{&pool, threads, true};
+        CHECK(bitwise_equal(units::reduce(policy, distances).in(m), sequential));
+    }
+    CHECK(units::reduce(units::execution::par, distances).in(m) == Approx(sequential));
+}
+
+
+TEST_CASE("parallel inner product and transform reduce", "[parallel]")
+{
+    std::vector<units::quantity<metre>> distances(50000, 2.0 * m);
+    std::vector<units::quantity<second>> durations(50000, 0.5 * s);
+
+    auto product = units::inner_product(units::execution::par, distances, durations);
+    STATIC_REQUIRE(std::is_same_v<decltype(product), decltype(distances[0] * durations[0])>);
+    CHECK(product.in(m * s) == 50000);
+
+    // only the pairs present in both ranges
+    std::vector<units::quantity<second>> fewer_durations(1000, 0.5 * s);
+    CHECK(units::inner_product(units::execution::par, distances, fewer_durations).in(m * s) == 1000);
+    CHECK(units::inner_product(units::execution::seq, fewer_durations, distances).in(m * s) == 1000);
+
+    auto areas = units::transform_reduce(units::execution::par_deterministic, distances,
+                                         [](const units::quantity<metre>& d) { return d * d; });
+    CHECK(areas.in(m * m) == 200000);
+}
+
+
+TEST_CASE("thread pool runs every task once", "[parallel]")
+{
+    units::thread_pool pool(3);
+    std::vector<int> runs(1000, 0);
+    std::vector<size_t> workers(1000, 0);
+    for(int repeat = 0; repeat < 20; ++repeat)
+        pool.run(runs.size(), 0, [&](size_t task, size_t worker)
+        {
+            workers[task] = std::max(workers[task], worker);
+            ++runs[task];
+        });
+    CHECK(std::all_of(runs.begin(), runs.end(), [](int count) { return count == 20; }));
+    CHECK(*std::max_element(workers.begin(), workers.end()) < 3);
+}
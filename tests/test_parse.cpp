@@ -0,0 +1,84 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/parse.hpp>
+#include <vector>
+
+
+namespace
+{
+    using known_units = units::symbol_table<metre, kilometre, millimetre, second, millisecond, minute>;
+}
+
+
+TEST_CASE("parse a quantity", "[parse]")
+{
+    auto distance = units::parse<metre>("12.5 km", known_units{});
+    REQUIRE(distance);
+    CHECK(distance->in(m) == 12500);
+
+    CHECK(units::parse<metre>("3m", known_units{})->in(m) == 3);
+    CHECK(units::parse<millimetre, int>("  -2 m  ", known_units{})->in(mm) == -2000);
+    CHECK(units::parse<second>("1.5 min", known_units{})->in(s) == Approx(90));
+
+    auto speed = units::parse<metre_per_second>("36 km/min", known_units{});
+    REQUIRE(speed);
+    CHECK(speed->in(metre_per_second{}) == Approx(600));
+
+    auto acceleration = units::parse<metre_per_second>("0.5 m*s/ms^2", known_units{});
+    REQUIRE(acceleration);
+    CHECK(acceleration->in(metre_per_second{}) == Approx(5e5));
+}
+
+
+TEST_CASE("parse rejects invalid text", "[parse]")
+{
+    CHECK_FALSE(units::parse<metre>("", known_units{}));
+    CHECK_FALSE(units::parse<metre>("km", known_units{}));
+    CHECK_FALSE(units::parse<metre>("12 s", known_units{}));
+    CHECK_FALSE(units::parse<metre>("12 furlong", known_units{}));
+    CHECK_FALSE(units::parse<metre>("12 km/", known_units{}));
+    CHECK_FALSE(units::parse<metre>("12 km\n13 km", known_units{}));
+    CHECK_FALSE(units::parse<metre_per_second>("12 m/s^0", known_units{}));
+}
+
+
+TEST_CASE("parse rejects huge exponents", "[parse]")
+{
+    CHECK(units::parse<metre>("1 km^127/km^126", known_units{})->in(m) == Approx(1000));
+    CHECK(units::parse<metre>("2 m^3/m^2", known_units{})->in(m) == 2);
+
+    // beyond the exponent limit
+    CHECK_FALSE(units::parse<metre>("1 m*km^200000000/km^200000000", known_units{}));
+    CHECK_FALSE(units::parse<metre>("1 m*km^128/km^128", known_units{}));
+    CHECK_FALSE(units::parse<metre>("1 m^2147483647*m^2147483647", known_units{}));
+    CHECK_FALSE(units::parse<metre>("1 m^-2147483648", known_units{}));
+    CHECK_FALSE(units::parse<metre>("1 m^99999999999", known_units{}));
+    // the power of a dimension goes beyond the limit
+    CHECK_FALSE(units::parse<metre>("1 m^100*m^100/m^199", known_units{}));
+    // the factor doesn't fit in a double
+    CHECK_FALSE(units::parse<metre>("1 km^120/m^119", known_units{}));
+    CHECK_FALSE(units::parse<metre>("1 mm^120/m^119", known_units{}));
+}
+
+
+TEST_CASE("parse lines", "[parse]")
+{
+    const std::string_view text = "1 km\r\n\n2.5 m\n  3 mm\n7 s\n4 m\n";
+    std::vector<units::quantity<metre>> distances(8, 0.0 * m);
+
+    auto result = units::parse_lines(text, units::span<units::quantity<metre>>(distances.data(), distances.size()),
+                                     known_units{});
+    CHECK_FALSE(result.ok);
+    REQUIRE(result.count == 3);
+    CHECK(distances[0].in(m) == 1000);
+    CHECK(distances[1].in(m) == 2.5);
+    CHECK(distances[2].in(m) == Approx(0.003));
+    CHECK(text.substr(result.consumed) == "7 s\n4 m\n");
+
+    auto rest = units::parse_lines(text.substr(result.consumed + 4),
+                                   units::span<units::quantity<metre>>(distances.data(), 1), known_units{});
+    CHECK(rest.ok);
+    CHECK(rest.count == 1);
+    CHECK(distances[0].in(m) == 4);
+}
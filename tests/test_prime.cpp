@@ -33,4 +33,41 @@ TEST_CASE("Prime factorization of power of 2", "[prime]")
     REQUIRE(res.size == 1);
     CHECK(res.factors[0].factor == 2);
     CHECK(res.factors[0].exponent == 63);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Prime factorization at compile time", "[prime]")
+{
+    {
+        constexpr uint64_t big_prime = 5'053'038'781'909'696'477;
+        constexpr auto res = units::prime_factorization(big_prime);
+        STATIC_REQUIRE(res.size == 1);
+        STATIC_REQUIRE(res.factors[0].factor == big_prime);
+        STATIC_REQUIRE(res.factors[0].exponent == 1);
+    }
+
+    {
+        // Product of the 2 largest primes smaller than 2^32
+        constexpr auto res = units::prime_factorization(4'294'967'291ULL * 4'294'967'279ULL);
+        STATIC_REQUIRE(res.size == 2);
+        STATIC_REQUIRE(res.factors[0].factor == 4'294'967'279ULL);
+        STATIC_REQUIRE(res.factors[0].exponent == 1);
+        STATIC_REQUIRE(res.factors[1].factor == 4'294'967'291ULL);
+        STATIC_REQUIRE(res.factors[1].exponent == 1);
+    }
+
+    {
+        constexpr auto res = units::prime_factorization(101ULL * 101 * 1'000'003 * 1'000'003);
+        STATIC_REQUIRE(res.size == 2);
+        STATIC_REQUIRE(res.factors[0].factor == 101);
+        STATIC_REQUIRE(res.factors[0].exponent == 2);
+        STATIC_REQUIRE(res.factors[1].factor == 1'000'003);
+        STATIC_REQUIRE(res.factors[1].exponent == 2);
+    }
+
+    {
+        // Product of the 15 first primes
+        constexpr auto res = units::prime_factorization(614'889'782'588'491'410ULL);
+        STATIC_REQUIRE(res.size == 15);
+        STATIC_REQUIRE(res.factors[14].factor == 47);
+    }
+}
@@ -2,6 +2,8 @@
 
 #include <catch2/catch.hpp>
 #include <units/quantity.hpp>
+#include <cstdint>
+#include <limits>
 
 
 TEST_CASE("quantity to and from scalar", "[quantity]")
@@ -49,4 +51,156 @@ TEST_CASE("Operation on quantities", "[quantity]")
     auto distance10_2 = speed * (10 * s);
     CHECK(distance10 == 20 * m);
     CHECK(distance10 == distance10_2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Conversion factors are constants", "[quantity]")
+{
+    using KiloToMilli = units::MultiplyMagnitude<kilometre::Magnitude, units::InverseMagnitude<millimetre::Magnitude>>;
+    STATIC_REQUIRE(units::detail::magnitude_factor<KiloToMilli, double> == 1e6);
+    STATIC_REQUIRE(units::detail::magnitude_factor<units::InverseMagnitude<KiloToMilli>, double> == 1e-6);
+
+    // rounded once from extended precision
+    using Pi = units::MagnitudeFromIrrational<units::pi>;
+    STATIC_REQUIRE(units::detail::magnitude_factor<Pi, double> == 3.141592653589793);
+    STATIC_REQUIRE(units::detail::magnitude_factor<Pi, float> == 3.14159265f);
+
+    // identity conversions give back the value untouched
+    units::quantity<metre, int64_t> big = int64_t(9'007'199'254'740'993) * m;
+    CHECK(big.in(m) == 9'007'199'254'740'993);
+}
+
+
+TEST_CASE("Rational magnitude on integers", "[quantity]")
+{
+    using rational_metre = units::quantity<metre, int64_t, units::ApplyMagnitudeAsRational>;
+    using rational_kilometre = units::quantity<kilometre, int64_t, units::ApplyMagnitudeAsRational>;
+
+    // exact above 2^24
+    rational_kilometre distance = int64_t(123'456'789) * km;
+    CHECK(distance.in(mm) == 123'456'789'000'000);
+    CHECK(distance.as(m) == rational_metre(int64_t(123'456'789'000) * m));
+
+    // truncated toward zero
+    rational_metre short_distance = int64_t(1'999) * m;
+    CHECK(short_distance.in(km) == 1);
+    CHECK((-short_distance).in(km) == -1);
+
+    // 1000 / 60
+    units::quantity<kilosecond, int, units::ApplyMagnitudeAsRational> duration = 7 * ks;
+    CHECK(duration.in(min) == 116);
+
+    // needs 128 bits intermediate products
+    struct odd_unit
+        : units::ScaledUnit<odd_unit, metre, units::MagnitudeFromRatio<std::ratio<10'000'000'019, 10'000'000'033>>>
+    {};
+    units::quantity<metre, int64_t, units::ApplyMagnitudeAsRational> odd_distance =
+        int64_t(50'000'000'095) * m;
+    CHECK(odd_distance.in<odd_unit>() == 50'000'000'165);
+    CHECK(units::quantity<metre, uint64_t, units::ApplyMagnitudeAsRational>(odd_distance).in<odd_unit>()
+          == 50'000'000'165);
+}
+
+
+TEST_CASE("Rational magnitude saturates on overflow", "[quantity]")
+{
+    constexpr int64_t highest = std::numeric_limits<int64_t>::max();
+    constexpr int64_t lowest = std::numeric_limits<int64_t>::min();
+    using rational_kilometre = units::quantity<kilometre, int64_t, units::ApplyMagnitudeAsRational>;
+
+    // integer factor
+    CHECK(rational_kilometre(int64_t(highest / 1000) * km).in(m) == highest / 1000 * 1000);
+    CHECK(rational_kilometre(int64_t(highest / 100) * km).in(m) == highest);
+    CHECK(rational_kilometre(int64_t(lowest / 100) * km).in(m) == lowest);
+    CHECK(units::quantity<kilometre, uint64_t, units::ApplyMagnitudeAsRational>(
+              std::numeric_limits<uint64_t>::max() * km).in(m) == std::numeric_limits<uint64_t>::max());
+
+    // fraction, 1000 / 60
+    using rational_kilosecond = units::quantity<kilosecond, int64_t, units::ApplyMagnitudeAsRational>;
+    CHECK(rational_kilosecond(int64_t(highest / 50 * 3) * ks).in(min) == highest / 50 * 50);
+    CHECK(rational_kilosecond(int64_t(highest) * ks).in(min) == highest);
+    CHECK(rational_kilosecond(int64_t(lowest) * ks).in(min) == lowest);
+
+    // result that doesn't fit in a narrower type
+    units::quantity<kilosecond, int32_t, units::ApplyMagnitudeAsRational> duration = int32_t(2'000'000'000) * ks;
+    CHECK(duration.in(min) == std::numeric_limits<int32_t>::max());
+    CHECK((-duration).in(min) == std::numeric_limits<int32_t>::min());
+
+    // 128 bits intermediate products
+    struct odd_unit
+        : units::ScaledUnit<odd_unit, metre, units::MagnitudeFromRatio<std::ratio<10'000'000'033, 10'000'000'019>>>
+    {};
+    units::quantity<metre, int64_t, units::ApplyMagnitudeAsRational> distance = int64_t(highest) * m;
+    CHECK(distance.in<odd_unit>() == int64_t(units::detail::int128_t(highest) * 10'000'000'019 / 10'000'000'033));
+    units::quantity<odd_unit, int64_t, units::ApplyMagnitudeAsRational> odd_distance = int64_t(highest) * odd_unit{};
+    CHECK(odd_distance.in(m) == highest);
+    CHECK((-odd_distance).in(m) == lowest);
+}
+
+
+TEST_CASE("Power of two magnitude", "[quantity]")
+{
+    struct kibimetre : units::ScaledUnit<kibimetre, metre, units::MagnitudeFromInt<1024>>
+    {};
+    STATIC_REQUIRE(units::detail::power_of_two_magnitude<kibimetre::Magnitude>::exponent == 10);
+    STATIC_REQUIRE(!units::detail::power_of_two_magnitude<kilometre::Magnitude>::value);
+
+    {
+        units::quantity<kibimetre, int64_t, units::ApplyMagnitudeAsRational> distance = int64_t(-3) * kibimetre{};
+        CHECK(distance.in(m) == -3072);
+        units::quantity<metre, int64_t, units::ApplyMagnitudeAsRational> short_distance = int64_t(-2047) * m;
+        CHECK(short_distance.in<kibimetre>() == -1);
+        units::quantity<metre, uint32_t, units::ApplyMagnitudeAsRational> unsigned_distance = uint32_t(2049) * m;
+        CHECK(unsigned_distance.in<kibimetre>() == 2);
+        CHECK(unsigned_distance.as<kibimetre>().in(m) == 2048);
+    }
+
+    {
+        // saturated when the result doesn't fit
+        constexpr int64_t max = std::numeric_limits<int64_t>::max();
+        units::quantity<kibimetre, int64_t> distance = int64_t(max >> 10) * kibimetre{};
+        CHECK(distance.in(m) == (max >> 10) << 10);
+        CHECK((distance + int64_t(1) * kibimetre{}).in(m) == max);
+        CHECK((-distance - int64_t(2) * kibimetre{}).in(m) == std::numeric_limits<int64_t>::min());
+        units::quantity<kibimetre, uint64_t, units::ApplyMagnitudeAsRational> unsigned_distance =
+            (std::numeric_limits<uint64_t>::max() >> 9) * kibimetre{};
+        CHECK(unsigned_distance.in(m) == std::numeric_limits<uint64_t>::max());
+        units::quantity<kibimetre, int16_t> short_distance = int16_t(100) * kibimetre{};
+        CHECK(short_distance.in(m) == std::numeric_limits<int16_t>::max());
+    }
+
+    {
+        // the default policy shifts integers too, exact above 2^24
+        units::quantity<kibimetre, int64_t> distance = int64_t(123'456'789'123) * kibimetre{};
+        CHECK(distance.in(m) == 126'419'752'061'952);
+        units::quantity<metre, int32_t> short_distance = int32_t(-16'777'217) * m;
+        CHECK(short_distance.in<kibimetre>() == -16'384);
+        STATIC_REQUIRE(units::ApplyMagnitudeAsFloat::apply<kibimetre::Magnitude>(int32_t(3)) == 3072);
+    }
+
+    {
+        units::quantity<metre> distance = 0.1 * m;
+        CHECK(distance.in<kibimetre>() == 0.1 / 1024);
+        CHECK(distance.in<kibimetre>() * 1024 == 0.1);
+    }
+}
+
+
+TEST_CASE("Lazy conversion chains", "[quantity]")
+{
+    units::quantity<metre> distance = 0.1 * m;
+
+    auto chain = distance.as_lazy<kilometre>().as_lazy<millimetre>();
+    CHECK(std::is_same_v<decltype(chain)::unit, millimetre>);
+    CHECK(std::is_same_v<decltype(chain)::pending_magnitude, units::InverseMagnitude<millimetre::Magnitude>>);
+
+    // a single factor, the km and mm ones cancel out
+    auto back = distance.as_lazy<kilometre>().as_lazy<millimetre>().as_lazy<metre>();
+    CHECK(std::is_same_v<decltype(back)::pending_magnitude, units::detail::magnitude_raw<>>);
+    CHECK(back.in<metre>() == 0.1);
+    CHECK(distance.as_lazy<kilometre>().as_lazy<millimetre>().in<metre>() == 0.1);
+
+    CHECK(chain.in(mm) == Approx(100));
+    units::quantity<millimetre> stored = chain;
+    CHECK(stored.in(mm) == Approx(100));
+    CHECK(chain.as<kilometre>().in(km) == Approx(0.0001));
+}
@@ -0,0 +1,109 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/quantity_channel.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("quantity channel push and pop", "[quantity_channel]")
+{
+    const std::string path = "units_test_channel.bin";
+    units::quantity_channel<metre, float> producer;
+    REQUIRE(producer.create(path, 6) == units::quantity_channel_error::none);
+    CHECK(producer.capacity() == 8);
+
+    units::quantity_channel<millimetre, float, metre> consumer;
+    REQUIRE(consumer.attach(path) == units::quantity_channel_error::none);
+    CHECK_FALSE(consumer.pop());
+
+    std::vector<units::quantity<metre, float>> samples;
+    for(int i = 0; i < 10; ++i)
+        samples.push_back(float(i) * m);
+    CHECK(producer.push(samples.data(), samples.size()) == 8);
+    CHECK_FALSE(producer.push(1.f * m));
+    CHECK(consumer.size() == 8);
+
+    std::vector<units::quantity<millimetre, float>> received(5, 0.f * mm);
+    CHECK(consumer.pop(received.data(), received.size()) == 5);
+    CHECK(received[4] == 4000.f * mm);
+
+    // the next values wrap around the end of the ring
+    CHECK(producer.push(samples.data() + 8, 2) == 2);
+    CHECK(producer.push(samples.data(), 3) == 3);
+    CHECK(consumer.pop(received.data(), received.size()) == 5);
+    CHECK(received[0] == 5000.f * mm);
+    CHECK(received[3] == 8000.f * mm);
+    CHECK(received[4] == 9000.f * mm);
+    CHECK(consumer.pop() == 0.f * mm);
+    CHECK(consumer.size() == 2);
+
+    producer.close();
+    consumer.close();
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE("quantity channel checks the unit when attaching", "[quantity_channel]")
+{
+    units::quantity_channel<metre> producer;
+    REQUIRE(producer.create(16) == units::quantity_channel_error::none);
+    REQUIRE(producer.fd() >= 0);
+
+    CHECK(units::quantity_channel<metre, float>().attach(producer.fd()) ==
+          units::quantity_channel_error::element_type_mismatch);
+    CHECK(units::quantity_channel<second>().attach(producer.fd()) == units::quantity_channel_error::dimension_mismatch);
+    CHECK(units::quantity_channel<millimetre>().attach(producer.fd()) ==
+          units::quantity_channel_error::magnitude_mismatch);
+    CHECK(units::quantity_channel<metre>().attach(-1) == units::quantity_channel_error::io_error);
+
+    units::quantity_channel<kilometre, double, metre> consumer;
+    REQUIRE(consumer.attach(producer.fd()) == units::quantity_channel_error::none);
+
+    // a producer and a consumer running at the same time
+    constexpr int count = 100000;
+    std::thread producer_thread([&]
+    {
+        for(int i = 0; i < count;)
+            if(producer.push(double(i) * m))
+                ++i;
+    });
+    std::vector<units::quantity<kilometre>> received(64, 0. * km);
+    int next = 0;
+    bool in_order = true;
+    while(next < count)
+    {
+        const size_t popped = consumer.pop(received.data(), received.size());
+        for(size_t i = 0; i < popped; ++i, ++next)
+            in_order = in_order && std::abs(received[i].in(m) - double(next)) < 1e-9;
+    }
+    producer_thread.join();
+    CHECK(in_order);
+    CHECK(consumer.size() == 0);
+}
+
+
+TEST_CASE("quantity channel rejects a corrupt header", "[quantity_channel]")
+{
+    units::quantity_channel<metre> producer;
+    REQUIRE(producer.create(16) == units::quantity_channel_error::none);
+
+    // a capacity that doesn't fit in the mapping, even if capacity * sizeof(T) overflows
+    const uint64_t capacity = uint64_t(1) << 62;
+    REQUIRE(::pwrite(producer.fd(), &capacity, sizeof(capacity),
+                     offsetof(units::detail::quantity_channel_header, capacity)) == sizeof(capacity));
+    CHECK(units::quantity_channel<metre>().attach(producer.fd()) == units::quantity_channel_error::bad_format);
+    // the endpoint already open keeps the capacity it was opened with
+    CHECK(producer.capacity() == 16);
+
+    // an index moved past the ring by the other endpoint doesn't make pop leave the ring
+    const uint64_t head = uint64_t(1) << 40;
+    REQUIRE(::pwrite(producer.fd(), &head, sizeof(head), offsetof(units::detail::quantity_channel_header, head)) ==
+            sizeof(head));
+    std::vector<units::quantity<metre>> received(64, 0. * m);
+    CHECK(producer.pop(received.data(), received.size()) == 16);
+}
@@ -0,0 +1,69 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/convert.hpp>
+#include <units/quantity_span.hpp>
+#include <vector>
+
+
+TEST_CASE("quantity is layout compatible with its value", "[quantity_span]")
+{
+    CHECK(sizeof(units::quantity<metre, float>) == sizeof(float));
+    CHECK(std::is_standard_layout_v<units::quantity<metre, int64_t>>);
+    CHECK(std::is_trivially_copyable_v<units::quantity<metre, double>>);
+}
+
+
+TEST_CASE("quantity_span views external memory", "[quantity_span]")
+{
+    double buffer[] = {1, 2, 3};
+    units::quantity_span<kilometre, double> distances(buffer, 3);
+    CHECK(distances.size() == 3);
+    CHECK(distances[1].in(m) == 2000);
+
+    distances[2] += 1.0 * km;
+    CHECK(buffer[2] == 4);
+    CHECK(distances.raw().data() == buffer);
+
+    const double readonly[] = {5, 6};
+    units::quantity_span<second, const double> durations(readonly, 2);
+    double sum = 0;
+    for(const auto& duration : durations)
+        sum += duration.in(ms);
+    CHECK(sum == 11000);
+
+    // can be converted in batch
+    std::vector<units::quantity<metre>> converted(3, 0.0 * m);
+    units::convert(distances, converted);
+    CHECK(converted[2].in(m) == 4000);
+}
+
+
+namespace
+{
+    struct Sample
+    {
+        int32_t id;
+        float altitude;
+        double duration;
+    };
+}
+
+
+TEST_CASE("strided_quantity_span views a field of records", "[quantity_span]")
+{
+    Sample samples[] = {{1, 10.f, 1.0}, {2, 20.f, 2.0}, {3, 30.f, 3.0}};
+
+    auto altitudes = units::make_strided_quantity_span<metre>(samples, 3, &Sample::altitude);
+    CHECK(altitudes.stride() == sizeof(Sample));
+    CHECK(altitudes[2].in(m) == 30.f);
+    altitudes[0] = 15.f * m;
+    CHECK(samples[0].altitude == 15.f);
+
+    const Sample* readonly = samples;
+    auto durations = units::make_strided_quantity_span<second>(readonly, 3, &Sample::duration);
+    double sum = 0;
+    for(const auto& duration : durations)
+        sum += duration.in(ms);
+    CHECK(sum == 6000);
+}
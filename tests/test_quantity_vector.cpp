@@ -0,0 +1,67 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/quantity_vector.hpp>
+
+
+TEST_CASE("quantity_vector element access", "[quantity_vector]")
+{
+    units::quantity_vector<metre> distances;
+    distances.push_back(1.0 * m);
+    distances.push_back(2.5 * m);
+    REQUIRE(distances.size() == 2);
+    CHECK(distances[1] == 2.5 * m);
+
+    distances[0] += 1.0 * m;
+    CHECK(distances[0].in(m) == 2.0);
+
+    double sum = 0;
+    for(const auto& distance : distances)
+        sum += distance.in(mm);
+    CHECK(sum == Approx(4500));
+
+    auto raw = distances.raw();
+    REQUIRE(raw.size() == 2);
+    CHECK(raw[0] == 2.0);
+    CHECK(raw[1] == 2.5);
+    raw[1] = 3.0;
+    CHECK(distances[1] == 3.0 * m);
+}
+
+
+TEST_CASE("quantity_vector bulk operations", "[quantity_vector]")
+{
+    units::quantity_vector<metre> distances;
+    const double raw_values[] = {1, 2, 3};
+    distances.append_raw(raw_values, 3);
+
+    const units::quantity<kilometre> far[] = {1.0 * km, 2.0 * km};
+    distances.append(far, 2);
+    REQUIRE(distances.size() == 5);
+    CHECK(distances[3].in(m) == 1000);
+    CHECK(distances[4].in(m) == 2000);
+
+    const double* buffer = distances.raw().data();
+    auto in_mm = std::move(distances).rescale<millimetre>();
+    CHECK(in_mm.raw().data() == buffer);
+    CHECK(in_mm[0].in(mm) == 1000);
+    CHECK(in_mm[4].in(mm) == 2'000'000);
+
+    std::vector<double> released = std::move(in_mm).release();
+    CHECK(released.size() == 5);
+    CHECK(released[1] == 2000);
+}
+
+
+TEST_CASE("quantity_vector with an arena", "[quantity_vector]")
+{
+    std::byte arena[1024];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+    units::pmr::quantity_vector<second> durations(&resource);
+    durations.reserve(16);
+    for(int i = 0; i < 16; ++i)
+        durations.push_back(double(i) * s);
+    CHECK(durations[15].in(ms) == 15000);
+    CHECK(reinterpret_cast<std::byte*>(durations.raw().data()) >= arena);
+    CHECK(reinterpret_cast<std::byte*>(durations.raw().data()) < arena + sizeof(arena));
+}
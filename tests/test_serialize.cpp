@@ -0,0 +1,114 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/serialize.hpp>
+#include <cstdint>
+#include <vector>
+
+
+namespace
+{
+    struct Mass : units::BaseDimension<Mass>
+    {
+        static constexpr uint64_t ordinal = 3;
+    };
+    struct gram : units::BaseUnit<gram, Mass>
+    {};
+
+    // without ordinal, its values can only be written without fingerprint
+    struct Luminosity : units::BaseDimension<Luminosity>
+    {};
+    struct candela : units::BaseUnit<candela, Luminosity>
+    {};
+}
+
+
+TEST_CASE("wire fingerprints", "[serialize]")
+{
+    // the values are part of the wire format, they only depend on the ordinals of the
+    // base dimensions and on the prime factors of the magnitudes
+    STATIC_REQUIRE(units::wire_fingerprint<gram, double> == 0x37c3b7ee77094c19u);
+    STATIC_REQUIRE(units::wire_fingerprint<metre, double> == 0x54f584aee7cc8acbu);
+    STATIC_REQUIRE(units::wire_fingerprint<kilometre, float, units::fingerprint_size::bits32> == 0xfe5f6b1eu);
+
+    STATIC_REQUIRE(units::wire_fingerprint<metre, double> != units::wire_fingerprint<metre, float>);
+    STATIC_REQUIRE(units::wire_fingerprint<metre, double> != units::wire_fingerprint<kilometre, double>);
+    STATIC_REQUIRE(units::wire_fingerprint<metre, double> != units::wire_fingerprint<second, double>);
+    STATIC_REQUIRE(units::wire_fingerprint<metre, int32_t> != units::wire_fingerprint<metre, uint32_t>);
+
+    STATIC_REQUIRE(units::detail::has_stable_signature<decltype(km / s)>);
+    STATIC_REQUIRE_FALSE(units::detail::has_stable_signature<candela>);
+}
+
+
+TEST_CASE("serialize a quantity", "[serialize]")
+{
+    std::byte buffer[16] = {};
+    const auto written = units::serialize(1.5 * km, buffer, sizeof(buffer));
+    REQUIRE(written.error == units::wire_error::none);
+    CHECK(written.size == units::serialized_size<double>());
+    CHECK(written.size == 16);
+    // little endian fingerprint first
+    CHECK(buffer[0] == std::byte(units::wire_fingerprint<kilometre, double> & 0xffu));
+
+    units::quantity<kilometre> distance = 0. * km;
+    CHECK(units::deserialize(buffer, written.size, distance).size == 16);
+    CHECK(distance == 1.5 * km);
+
+    units::quantity<metre> in_metres = 0. * m;
+    CHECK(units::deserialize(buffer, written.size, in_metres).error == units::wire_error::fingerprint_mismatch);
+    CHECK(units::deserialize<units::fingerprint_size::bits64, millimetre, kilometre>(buffer, written.size, in_metres)
+              .error == units::wire_error::none);
+    CHECK(in_metres == 1500. * m);
+
+    units::quantity<kilometre, float> single = 0.f * km;
+    CHECK(units::deserialize(buffer, written.size, single).error == units::wire_error::fingerprint_mismatch);
+    CHECK(units::deserialize(buffer, 15, distance).error == units::wire_error::truncated);
+    CHECK(units::serialize(1. * km, buffer, 15).error == units::wire_error::truncated);
+
+    // without fingerprint only the value is written
+    const auto raw = units::serialize<units::fingerprint_size::none>(int32_t(7) * s, buffer, sizeof(buffer));
+    CHECK(raw.size == 4);
+    units::quantity<second, int32_t> duration = int32_t(0) * s;
+    CHECK(units::deserialize<units::fingerprint_size::none>(buffer, raw.size, duration).count == 1);
+    CHECK(duration == int32_t(7) * s);
+
+    const auto intensity = units::serialize<units::fingerprint_size::none>(2.f * candela{}, buffer, sizeof(buffer));
+    CHECK(intensity.size == 4);
+}
+
+
+TEST_CASE("serialize an array of quantities", "[serialize]")
+{
+    std::vector<units::quantity<millimetre, float>> samples;
+    for(int i = 0; i < 100; ++i)
+        samples.push_back(float(i) * mm);
+
+    constexpr auto bits32 = units::fingerprint_size::bits32;
+    std::vector<std::byte> buffer(units::serialized_size<float, bits32>(samples.size()));
+    CHECK(buffer.size() == 4 + 8 + 400);
+    const auto written = units::serialize<bits32>(samples.data(), samples.size(), buffer.data(), buffer.size());
+    REQUIRE(written.error == units::wire_error::none);
+    CHECK(written.count == 100);
+
+    CHECK(units::serialized_count<float, bits32>(buffer.data(), buffer.size()).count == 100);
+
+    std::vector<units::quantity<millimetre, float>> same(100, 0.f * mm);
+    const auto read = units::deserialize<bits32>(buffer.data(), buffer.size(), same.data(), same.size());
+    CHECK(read.size == buffer.size());
+    CHECK(read.count == 100);
+    CHECK(same == samples);
+
+    std::vector<units::quantity<metre, float>> in_metres(100, -1.f * m);
+    CHECK(units::deserialize<bits32>(buffer.data(), buffer.size(), in_metres.data(), in_metres.size()).error ==
+          units::wire_error::fingerprint_mismatch);
+    CHECK(in_metres[1] == -1.f * m);
+    CHECK(units::deserialize<bits32, millimetre>(buffer.data(), buffer.size(), in_metres.data(), in_metres.size())
+              .error == units::wire_error::none);
+    CHECK(in_metres[50] == 0.05f * m);
+
+    CHECK(units::deserialize<bits32>(buffer.data(), buffer.size(), same.data(), 99).error ==
+          units::wire_error::too_many_values);
+    CHECK(units::deserialize<bits32>(buffer.data(), buffer.size() - 1, same.data(), same.size()).error ==
+          units::wire_error::truncated);
+}
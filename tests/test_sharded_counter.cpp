@@ -0,0 +1,39 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/sharded_counter.hpp>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("sharded counter", "[sharded_counter]")
+{
+    units::sharded_quantity_counter<metre, int64_t> counter(3);
+    CHECK(counter.shard_count() == 4);
+    CHECK(counter.read() == int64_t(0) * m);
+
+    counter.add(int64_t(2) * km);
+    counter += int64_t(5) * m;
+    CHECK(counter.read() == int64_t(2005) * m);
+
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 6; ++thread)
+        threads.emplace_back([&]
+        {
+            for(int i = 0; i < 10000; ++i)
+                counter.add(int64_t(1) * m);
+        });
+    for(auto& thread : threads)
+        thread.join();
+    CHECK(counter.read() == int64_t(62005) * m);
+
+    counter.reset();
+    CHECK(counter.read() == int64_t(0) * m);
+
+    units::sharded_quantity_counter<second> elapsed;
+    CHECK(elapsed.shard_count() >= 1);
+    elapsed.add(1.5 * min);
+    elapsed.add(250. * ms);
+    CHECK(elapsed.read() == 90.25 * s);
+}
@@ -10,4 +10,28 @@ TEST_CASE("Units combine correctly", "[unit]")
     CHECK(std::is_same_v<decltype(km / ks), metre_per_second>);
     CHECK(std::is_same_v<decltype(mm / ms), metre_per_second>);
     CHECK(std::is_same_v<decltype(km * ms), decltype(mm * ks)>);
-}
\ No newline at end of file
+}
+
+struct Zeta : units::BaseDimension<Zeta>
+{
+    static constexpr uint64_t ordinal = 10;
+};
+struct Alpha : units::BaseDimension<Alpha>
+{};
+struct Beta : units::BaseDimension<Beta>
+{};
+
+template<>
+struct meta::ordinal<Alpha>
+{
+    static constexpr uint64_t value = 11;
+};
+
+TEST_CASE("Base dimensions are ordered by ordinal, then by name", "[unit]")
+{
+    using Combined = units::detail::make_combined_dimension_raw<
+        units::Power<Length, 1>, units::Power<Beta, 1>, units::Power<Alpha, 1>, units::Power<Zeta, 1>>;
+    using Expected = units::detail::dimension_raw<
+        units::Power<Length, 1>, units::Power<Zeta, 1>, units::Power<Alpha, 1>, units::Power<Beta, 1>>;
+    CHECK(std::is_same_v<Combined, Expected>);
+}
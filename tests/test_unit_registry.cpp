@@ -0,0 +1,75 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/unit_registry.hpp>
+#include <cstdint>
+#include <vector>
+
+
+namespace
+{
+    using registry = units::unit_registry<metre, kilometre, millimetre, second, minute>;
+}
+
+
+TEST_CASE("unit registry factors", "[unit_registry]")
+{
+    STATIC_REQUIRE(registry::size() == 5);
+    STATIC_REQUIRE(registry::index_of<millimetre> == 2);
+    STATIC_REQUIRE(registry::factors<double>[1][2] == 1e6);
+    STATIC_REQUIRE(registry::factors<double>[4][3] == 60);
+    STATIC_REQUIRE(registry::factors<double>[0][3] == 0);
+    STATIC_REQUIRE(registry::compatible(0, 1));
+    STATIC_REQUIRE_FALSE(registry::compatible(1, 4));
+    STATIC_REQUIRE_FALSE(registry::compatible(0, 5));
+    STATIC_REQUIRE_FALSE(registry::compatible(size_t(-1), 0));
+}
+
+
+TEST_CASE("unit registry conversion", "[unit_registry]")
+{
+    CHECK(registry::convert(2.5, registry::index_of<kilometre>, registry::index_of<metre>) == 2500);
+    CHECK(registry::convert(120, registry::index_of<second>, registry::index_of<minute>) == 2);
+    CHECK(registry::convert(7.0, 3, 3) == 7);
+
+    std::vector<double> values = {1, 2, 3};
+    CHECK(registry::convert(values.data(), values.data(), values.size(), registry::index_of<kilometre>,
+                            registry::index_of<millimetre>));
+    CHECK(values[2] == 3e6);
+
+    std::vector<float> out(3);
+    const float minutes[] = {1.f, 0.5f, 2.f};
+    CHECK(registry::convert(minutes, out.data(), 3, registry::index_of<minute>, registry::index_of<second>));
+    CHECK(out[1] == 30.f);
+}
+
+
+TEST_CASE("unit registry converts integers exactly", "[unit_registry]")
+{
+    STATIC_REQUIRE(*registry::convert(int64_t(123456789), registry::index_of<kilometre>, registry::index_of<metre>) ==
+                   123456789000);
+    CHECK(*registry::convert(int64_t(123456789), 1, 2) == 123456789000000);
+    CHECK(*registry::convert(int64_t(123456789123), 2, 0) == 123456789);
+    CHECK(*registry::convert(int32_t(16777217), 4, 3) == 1006633020);
+    CHECK(*registry::convert(int64_t(-2999), 3, 4) == -49);
+    // saturated like ApplyMagnitudeAsRational
+    CHECK(*registry::convert(INT64_MAX, 1, 2) == INT64_MAX);
+
+    std::vector<int64_t> values = {123456789, -987654321, 16777217};
+    CHECK(registry::convert(values.data(), values.data(), values.size(), registry::index_of<kilometre>,
+                            registry::index_of<millimetre>));
+    CHECK(values == std::vector<int64_t>{123456789000000, -987654321000000, 16777217000000});
+}
+
+
+TEST_CASE("unit registry rejects invalid conversions", "[unit_registry]")
+{
+    CHECK_FALSE(registry::convert(1.0, registry::index_of<metre>, registry::index_of<second>));
+    CHECK_FALSE(registry::convert(1.0, 0, 5));
+    CHECK_FALSE(registry::convert(1.0, 17, 17));
+
+    std::vector<double> values = {1, 2, 3};
+    CHECK_FALSE(registry::convert(values.data(), values.data(), values.size(), 1, 4));
+    CHECK_FALSE(registry::convert(values.data(), values.data(), values.size(), 0, 99));
+    CHECK(values == std::vector<double>{1, 2, 3});
+}
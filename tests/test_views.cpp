@@ -0,0 +1,66 @@
+#include "unit_definition.h"
+
+#include <catch2/catch.hpp>
+#include <units/quantity_span.hpp>
+#include <units/views.hpp>
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+
+TEST_CASE("views as converts lazily", "[views]")
+{
+    std::vector<units::quantity<metre>> distances = {500. * m, 1500. * m, -20. * m, 2000. * m};
+
+    auto kilometres = distances | units::views::as<kilometre>;
+    STATIC_REQUIRE(std::ranges::random_access_range<decltype(kilometres)>);
+    STATIC_REQUIRE(std::ranges::sized_range<decltype(kilometres)>);
+    STATIC_REQUIRE(std::is_same_v<std::ranges::range_value_t<decltype(kilometres)>, units::quantity<kilometre>>);
+    REQUIRE(kilometres.size() == 4);
+    CHECK(kilometres[1] == 1.5 * km);
+
+    // the source is read again on every pass
+    distances[1] = 3000. * m;
+    CHECK(kilometres[1] == 3. * km);
+
+    std::vector<units::quantity<kilometre>> positive;
+    for(auto distance : distances | std::views::filter([](auto d) { return d > 0. * m; }) |
+                            units::views::as<kilometre>)
+        positive.push_back(distance);
+    CHECK(positive == std::vector<units::quantity<kilometre>>{0.5 * km, 3. * km, 2. * km});
+
+    // same magnitude, the quantities are seen in place
+    auto same = distances | units::views::as<metre>;
+    STATIC_REQUIRE(std::ranges::contiguous_range<decltype(same)>);
+    CHECK(same.data() == distances.data());
+
+    auto seconds = units::views::as<second>(std::vector<units::quantity<minute>>{1. * min, 2. * min});
+    CHECK(std::ranges::equal(seconds, std::vector<units::quantity<second>>{60. * s, 120. * s}));
+}
+
+
+TEST_CASE("views raw unwraps quantities", "[views]")
+{
+    std::vector<units::quantity<metre, float>> distances = {1.f * m, 2.f * m, 3.f * m};
+
+    auto values = distances | units::views::raw;
+    STATIC_REQUIRE(std::ranges::contiguous_range<decltype(values)>);
+    STATIC_REQUIRE(std::is_same_v<decltype(values), std::span<float>>);
+    values[0] = 10.f;
+    CHECK(distances[0] == 10.f * m);
+
+    const auto& read_only = distances;
+    STATIC_REQUIRE(std::is_same_v<decltype(read_only | units::views::raw), std::span<const float>>);
+
+    std::vector<float> samples = {4.f, 5.f};
+    units::quantity_span<millimetre, float> span(samples.data(), samples.size());
+    CHECK((span | units::views::raw).data() == samples.data());
+
+    // not contiguous, the values are still references to the quantities
+    for(float& value : distances | std::views::reverse | units::views::raw)
+        value *= 2;
+    CHECK(distances[2] == 6.f * m);
+
+    auto in_millimetres = distances | std::views::take(2) | units::views::as<millimetre> | units::views::raw;
+    CHECK(std::ranges::equal(in_millimetres, std::vector<float>{20000.f, 4000.f}));
+}
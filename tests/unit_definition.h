@@ -1,32 +1,57 @@
 #ifndef UNIT_DEFINITION_HPP
 #define UNIT_DEFINITION_HPP
 
+#include <cstdint>
 #include <ratio>
+#include <string_view>
 #include <units/unit.hpp>
 
 
 struct Length : units::BaseDimension<Length>
-{};
+{
+    static constexpr std::string_view symbol = "L";
+    static constexpr unsigned dynamic_slot = 0;
+    static constexpr uint64_t ordinal = 1;
+};
 struct Time : units::BaseDimension<Time>
-{};
+{
+    static constexpr std::string_view symbol = "T";
+    static constexpr unsigned dynamic_slot = 1;
+    static constexpr uint64_t ordinal = 2;
+    static constexpr bool is_time = true;
+};
 struct Speed : units::CombinedDimension<Speed, units::Power<Length, 1>, units::Power<Time, -1>>
 {};
 
 struct metre : units::BaseUnit<metre, Length>
-{};
+{
+    static constexpr std::string_view symbol = "m";
+};
 struct kilometre : units::ScaledUnit<kilometre, metre, units::MagnitudeFromRatio<std::kilo>>
-{};
+{
+    static constexpr std::string_view symbol = "km";
+};
 struct millimetre : units::ScaledUnit<millimetre, metre, units::MagnitudeFromRatio<std::milli>>
-{};
+{
+    static constexpr std::string_view symbol = "mm";
+};
 
 struct second : units::BaseUnit<second, Time>
-{};
+{
+    static constexpr std::string_view symbol = "s";
+};
 struct kilosecond : units::ScaledUnit<kilosecond, second, units::MagnitudeFromRatio<std::kilo>>
-{};
+{
+    static constexpr std::string_view symbol = "ks";
+};
 struct millisecond : units::ScaledUnit<millisecond, second, units::MagnitudeFromRatio<std::milli>>
-{};
+{
+    static constexpr std::string_view symbol = "ms";
+};
 struct minute : units::ScaledUnit<minute, second, units::MagnitudeFromInt<60>>
-{};
+{
+    static constexpr std::string_view symbol = "min";
+};
 
 struct metre_per_second : units::BaseUnit<metre_per_second, Speed>
 {};